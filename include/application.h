@@ -2,12 +2,33 @@
 #define APPLICATION_H
 
 #include "admin.h"
+#include "autocomplete.h"
+#include "bestsellers.h"
 #include "cart.h"
+#include "cartstore.h"
+#include "changefeed.h"
 #include "customer.h"
+#include "customerreach.h"
+#include "customerstats.h"
+#include "facetindex.h"
 #include "filemanager.h"
+#include "inventory.h"
 #include "order.h"
+#include "orderindex.h"
+#include "orderlines.h"
 #include "product.h"
+#include "salesrollup.h"
+#include "promotions.h"
+#include "recommendations.h"
+#include "settings.h"
+#include "searchcache.h"
+#include "stockalerts.h"
+#include "stockholds.h"
+#include "sortedindex.h"
+#include "stockledger.h"
+#include "warehouse.h"
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 using namespace std;
@@ -20,12 +41,68 @@ using namespace std;
 class Application {
 private:
   vector<Product> products;
+  unordered_map<string, size_t> productSlots; // Product ID -> position
   vector<shared_ptr<User>> users;
   vector<Order> orders;
+  OrderIndex orderIndex; // Slots are positions in `orders`
+
+  // Revenue/units/orders per day, product and category
+  SalesRollup salesRollup;
+
+  // "Frequently bought together" lists built from order history
+  CoPurchaseRecommender recommender;
+
+  // Streaming top sellers over the last hour/day/week
+  BestSellerTracker bestSellers;
+
+  // Distinct customers per product/category and month (HyperLogLog)
+  CustomerReach customerReach;
+
+  // Order count, lifetime spend and last order per customer
+  CustomerStats customerStats;
   shared_ptr<User> currentUser;
   Cart currentCart;
   bool running;
 
+  // Marks open carts stale when a product they hold changes
+  ProductChangeFeed cartFeed;
+
+  StoreSettings settings;
+
+  // Live stock counters used to reserve stock at checkout, plus timed
+  // holds for items sitting in carts
+  InventoryEngine inventory;
+  StockHoldManager stockHolds;
+
+  // Append-only history of every stock movement; product quantities are
+  // the ledger's replayed levels
+  StockLedger stockLedger;
+
+  // Per-location split of each product's stock
+  WarehouseStock warehouseStock;
+
+  // Low/out-of-stock crossings, raised from onProductChanged; the admin
+  // panel reads them through its own subscription
+  StockAlertMonitor stockAlerts;
+  size_t alertSubscriber;
+
+  // Compiled discount and coupon rules applied to carts at checkout
+  PromotionEngine promotions;
+
+  // Catalog indexes (kept in sync with products)
+  FacetIndex facetIndex;
+  SortedIndex<Money> priceIndex;
+  SortedIndex<string> nameIndex;
+
+  // Bumped on every product mutation; cached search results from an
+  // older version are discarded
+  uint64_t catalogVersion;
+  SearchCache searchCache;
+
+  // Prefix completion over names and categories, weighted by units sold
+  AutocompleteService autocomplete;
+  unordered_map<string, uint64_t> unitsSold;
+
   // ============================================
   // MAIN MENUS
   // ============================================
@@ -39,12 +116,16 @@ private:
   void login();
   void registerCustomer();
   void logout();
+  void restoreCart();
+  void persistCart();
+  void refreshCart();
 
   // ============================================
   // CUSTOMER FEATURES
   // ============================================
   void browseProducts();
   void searchProducts();
+  void filterProducts();
   void addToCart();
   void viewCart();
   void checkout();
@@ -60,14 +141,98 @@ private:
   void deleteProduct();
   void viewAllOrders();
   void updateOrderStatus();
+  void batchUpdateOrderStatus();
   void viewAllUsers();
+  void viewSystemStats();
+  void storeSettings();
+  void viewStockHistory();
+  void viewStockAlerts();
+  void manageWarehouses();
+  OrderQuery promptOrderQuery();
+  string pickOrder(const OrderQuery &query, const string &title);
+  void managePromotions();
+  void viewSalesReports();
+  void viewCustomerReach();
+  void viewOrderAnalytics();
+  void runAnalyticsBenchmark();
 
   // ============================================
   // HELPERS
   // ============================================
   void loadData();
   void displayProductList() const;
+  void displayProductTable(const vector<const Product *> &rows) const;
   Product *findProductById(const string &productId);
+  const Product *findProductById(const string &productId) const;
+  void reindexProducts(size_t from);
+  Order *findOrder(const string &orderId);
+  ProductLookup productLookup() const;
+  string adminReference() const;
+
+  // ============================================
+  // STOCK LEDGER
+  // ============================================
+  void reconcileStockLedger();
+  void recordStockMovement(const string &productId, StockEventType type,
+                           int delta, const string &reference);
+
+  // ============================================
+  // WAREHOUSES
+  // ============================================
+  void reconcileWarehouseStock();
+  void saveWarehouseStock() const;
+  size_t chooseWarehouse(const string &productId) const;
+  string shippingAddress() const;
+
+  // ============================================
+  // PROMOTIONS
+  // ============================================
+  void displayPricing(const PricedCart &priced) const;
+  void repriceSavedCarts();
+
+  // ============================================
+  // SALES ROLLUPS
+  // ============================================
+  void loadSalesRollups();
+  void saveSalesRollups() const;
+
+  // ============================================
+  // RECOMMENDATIONS
+  // ============================================
+  void loadRecommendations();
+  void saveRecommendations() const;
+  void displayRecommendations(const vector<string> &productIds) const;
+
+  // ============================================
+  // BEST SELLERS
+  // ============================================
+  void warmBestSellers();
+  void displayBestSellers(SalesWindow window, size_t limit) const;
+
+  // ============================================
+  // ORDER STATUS
+  // ============================================
+  size_t applyStatusChange(const vector<string> &orderIds,
+                           OrderStatus newStatus, vector<string> &skipped);
+  vector<string> matchingOrderIds(const OrderQuery &query) const;
+
+  // ============================================
+  // CUSTOMER STATS
+  // ============================================
+  void loadCustomerStats();
+  void persistCustomerStats(int customerId) const;
+  void saveCustomerStats() const;
+  void rebuildCustomerStats();
+
+  // ============================================
+  // CATALOG INDEX MAINTENANCE
+  // ============================================
+  void rebuildIndexes();
+  static string nameKey(const string &name);
+  void scheduleAutocompleteRebuild();
+  void applyFlashSales();
+  void onProductChanged(const Product &product);
+  void onProductRemoved(const string &productId);
 
 public:
   Application();
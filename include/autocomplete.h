@@ -0,0 +1,109 @@
+#ifndef AUTOCOMPLETE_H
+#define AUTOCOMPLETE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// COMPLETION STRUCT
+// ============================================
+struct Completion {
+  string text;     // Display text (product name or category)
+  uint64_t weight; // Popularity - higher ranks first
+};
+
+// ============================================
+// COMPLETION TRIE CLASS
+// ============================================
+// Immutable, compact prefix trie. Nodes, edges and per-node top-k lists
+// live in flat arrays; each node's edges are contiguous and sorted by
+// label, and every node stores its best completions precomputed, so a
+// lookup walks the prefix and returns that list without visiting the
+// subtree below it.
+
+class CompletionTrie {
+private:
+  struct Node {
+    uint32_t firstEdge = 0;
+    uint32_t edgeCount = 0;
+    uint32_t firstTop = 0;
+    uint32_t topCount = 0;
+  };
+
+  vector<Node> nodes; // nodes[0] is the root
+  vector<char> edgeLabels;
+  vector<uint32_t> edgeTargets;
+  vector<uint32_t> topTerms; // Indexes into terms, best first
+  vector<Completion> terms;
+
+  int findChild(uint32_t node, char label) const;
+
+public:
+  static constexpr size_t MAX_TOP_K = 8;
+
+  // ============================================
+  // BUILD
+  // ============================================
+  static shared_ptr<const CompletionTrie> build(vector<Completion> terms);
+
+  // ============================================
+  // QUERIES
+  // ============================================
+  vector<Completion> complete(const string &prefix, size_t k) const;
+  size_t nodeCount() const { return nodes.size(); }
+  size_t termCount() const { return terms.size(); }
+};
+
+// ============================================
+// AUTOCOMPLETE SERVICE CLASS
+// ============================================
+// Serves completions from the current trie while a background thread
+// builds replacements. Rebuild requests that arrive while a build is
+// running are coalesced - only the newest snapshot gets built.
+
+class AutocompleteService {
+private:
+  shared_ptr<const CompletionTrie> current;
+
+  mutex requestMutex;
+  condition_variable requestReady;
+  vector<Completion> pendingTerms;
+  bool hasPending;
+  bool stopping;
+  uint64_t rebuildCount;
+  thread worker;
+
+  void workerLoop();
+
+public:
+  // ============================================
+  // CONSTRUCTORS
+  // ============================================
+  AutocompleteService();
+  ~AutocompleteService();
+
+  AutocompleteService(const AutocompleteService &) = delete;
+  AutocompleteService &operator=(const AutocompleteService &) = delete;
+
+  // ============================================
+  // OPERATIONS
+  // ============================================
+  void requestRebuild(vector<Completion> terms);
+  vector<Completion> complete(const string &prefix, size_t k = 5) const;
+
+  // ============================================
+  // GETTERS
+  // ============================================
+  size_t getTermCount() const;
+  size_t getNodeCount() const;
+  uint64_t getRebuildCount();
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef BESTSELLERS_H
+#define BESTSELLERS_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// SPACE-SAVING SUMMARY
+// ============================================
+// Weighted Space-Saving: at most `capacity` counters. A product without
+// a counter takes over the smallest one, inheriting its count as error,
+// so every estimate is an over-count by at most `error`, and any product
+// with more than total/capacity units is guaranteed to be present.
+// Counters sit in a min-heap, so an update costs O(log capacity) - a
+// fixed bound, independent of how many products or orders there are.
+
+struct HeavyHitter {
+  string productId;
+  int64_t units = 0; // Estimated (never under-counted)
+  int64_t error = 0; // Units may be over-counted by up to this much
+};
+
+class SpaceSavingSummary {
+private:
+  size_t capacity;
+  vector<HeavyHitter> heap; // Min-heap on units
+  unordered_map<string, size_t> position;
+
+  void place(size_t index, HeavyHitter counter);
+  void siftUp(size_t index);
+  void siftDown(size_t index);
+
+public:
+  explicit SpaceSavingSummary(size_t capacity);
+
+  void add(const string &productId, int64_t units);
+  void clear();
+  bool contains(const string &productId) const {
+    return position.count(productId) > 0;
+  }
+  bool isFull() const { return heap.size() == capacity; }
+  // Smallest counter; an absent product sold at most this many units
+  int64_t getFloor() const { return isFull() ? heap.front().units : 0; }
+  const vector<HeavyHitter> &getCounters() const { return heap; }
+};
+
+// ============================================
+// BEST SELLER TRACKER CLASS
+// ============================================
+// Units sold per product over sliding windows, fed one order line at a
+// time from checkout. Each window is a ring of time buckets holding one
+// Space-Saving summary each:
+//
+//   LAST_HOUR  12 x 5 minutes
+//   LAST_DAY   24 x 1 hour
+//   LAST_WEEK   7 x 1 day
+//
+// A bucket is wiped when its slot comes round again, so memory is fixed
+// at 43 summaries whatever the sales volume. A query merges the buckets
+// inside the window; the window slides by one bucket at a time.
+
+enum class SalesWindow { LAST_HOUR, LAST_DAY, LAST_WEEK };
+
+class BestSellerTracker {
+private:
+  struct BucketRing {
+    int64_t bucketSeconds;
+    vector<SpaceSavingSummary> buckets;
+    vector<int64_t> bucketStart; // Epoch second each slot was opened at
+  };
+
+  vector<BucketRing> rings; // Indexed by SalesWindow
+
+public:
+  static const size_t COUNTERS_PER_BUCKET = 64;
+
+  BestSellerTracker();
+
+  void record(const string &productId, int units, time_t soldAt);
+  void clear();
+
+  // Top `limit` products in the window ending at `now`, most units first
+  vector<HeavyHitter> top(SalesWindow window, time_t now,
+                          size_t limit) const;
+
+  static string windowToString(SalesWindow window);
+};
+
+#endif
@@ -2,32 +2,68 @@
 #define CART_H
 
 #include "product.h"
+#include <functional>
 #include <utility>
 #include <vector>
 
 using namespace std;
 
+// Resolves a product ID to the live catalog entry (nullptr if gone)
+using ProductLookup = function<const Product *(const string &)>;
+
 // ============================================
 // CART ITEM STRUCT
 // ============================================
+// A cart line only keeps what the order needs: the product ID, the
+// quantity and the price at the time it was added. Names and other
+// details are looked up in the catalog when displayed.
 struct CartItem {
-  Product product;
+  string productId;
   int quantity;
+  Money price; // Unit price snapshot
+
+  CartItem(const string &id, int qty, Money unitPrice)
+      : productId(id), quantity(qty), price(unitPrice) {}
+
+  Money getSubtotal() const { return price * quantity; }
+};
 
-  CartItem(const Product &p, int qty) : product(p), quantity(qty) {}
+// ============================================
+// CART CHANGE STRUCT
+// ============================================
+// What refresh() found when it re-read a stale line from the catalog
+enum class CartChangeType { PRICE_CHANGED, LOW_STOCK, REMOVED };
 
-  double getSubtotal() const { return product.getPrice() * quantity; }
+struct CartChange {
+  string productId;
+  CartChangeType type;
+  Money oldPrice;
+  Money newPrice;
+  int available; // Units on hand (LOW_STOCK)
 };
 
 // ============================================
 // CART CLASS
 // ============================================
-// Shopping cart for customer purchases
+// Shopping cart for customer purchases. Product updates arrive through
+// markStale() (see ProductChangeFeed); the affected lines are re-read
+// from the catalog only when refresh() is called, and the total is
+// cached until the cart changes.
 
 class Cart {
 private:
+  // Flat map: lines sorted by productId, found by binary search
   vector<CartItem> items;
 
+  // Products changed since the last refresh()
+  vector<string> staleProducts;
+
+  mutable Money cachedTotal;
+  mutable bool totalValid = false;
+
+  vector<CartItem>::iterator lowerBound(const string &productId);
+  vector<CartItem>::const_iterator lowerBound(const string &productId) const;
+
 public:
   // ============================================
   // CONSTRUCTORS
@@ -40,21 +76,31 @@ public:
   void addItem(const Product &product, int quantity = 1);
   void removeItem(const string &productId);
   void updateQuantity(const string &productId, int newQuantity);
+  void restoreItem(const CartItem &item); // Saved line, price kept as-is
   void clear();
 
+  // ============================================
+  // CHANGE PROPAGATION
+  // ============================================
+  void markStale(const string &productId);
+  void markAllStale();
+  bool isStale() const { return !staleProducts.empty(); }
+  // Re-price stale lines from the catalog and drop deleted products
+  vector<CartChange> refresh(const ProductLookup &lookup);
+
   // ============================================
   // DISPLAY
   // ============================================
-  void displayCart() const;
+  void displayCart(const ProductLookup &lookup) const;
 
   // ============================================
   // GETTERS
   // ============================================
-  double getTotal() const;
+  Money getTotal() const;
   int getItemCount() const;
   int getTotalQuantity() const;
   bool isEmpty() const { return items.empty(); }
-  vector<CartItem> getItems() const { return items; }
+  const vector<CartItem> &getItems() const { return items; }
 
   // ============================================
   // ITEM LOOKUP
@@ -0,0 +1,42 @@
+#ifndef CARTSTORE_H
+#define CARTSTORE_H
+
+#include "cart.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// CART STORE CLASS
+// ============================================
+// Saved carts, one small file per customer under data/carts/ keyed by
+// customer ID, so loading or saving a cart touches only that customer's
+// file and costs O(cart size). The format is a version line followed by
+// one "productId quantity priceCents" line per cart line:
+//
+//   MXC1
+//   P001 2 129999
+//
+// Saves go to a temp file that is renamed over the old one, so a crash
+// mid-write leaves the previous cart intact.
+
+class CartStore {
+private:
+  static const string CARTS_DIRECTORY;
+  static const string FORMAT_HEADER;
+
+  static string pathFor(int customerId);
+
+public:
+  // ============================================
+  // STORAGE
+  // ============================================
+  static void ensureDirectory();
+  static Cart load(int customerId); // Empty cart if none saved
+  static void save(int customerId, const Cart &cart);
+  static void remove(int customerId);
+  static vector<int> listCustomers(); // Customers with a saved cart
+};
+
+#endif
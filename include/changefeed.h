@@ -0,0 +1,43 @@
+#ifndef CHANGEFEED_H
+#define CHANGEFEED_H
+
+#include "cart.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// PRODUCT CHANGE FEED CLASS
+// ============================================
+// Carts subscribe to the products they hold. When a product changes,
+// publish() marks only the carts holding it as stale - O(affected carts)
+// - and each cart re-reads those lines the next time it is refreshed,
+// instead of every cart re-checking every line at checkout.
+//
+// Subscribers are not owned; a cart must unsubscribeAll() before it is
+// destroyed.
+
+class ProductChangeFeed {
+private:
+  unordered_map<string, vector<Cart *>> subscribersByProduct;
+  unordered_map<Cart *, vector<string>> productsByCart;
+
+public:
+  // ============================================
+  // SUBSCRIPTIONS
+  // ============================================
+  void subscribe(const string &productId, Cart *cart);
+  void unsubscribe(const string &productId, Cart *cart);
+  void unsubscribeAll(Cart *cart);
+  size_t getSubscriberCount(const string &productId) const;
+
+  // ============================================
+  // PUBLISHING
+  // ============================================
+  // Returns the number of carts marked stale
+  size_t publish(const string &productId);
+};
+
+#endif
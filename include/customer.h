@@ -12,7 +12,6 @@ class Customer : public User {
 private:
   string address;
   string phone;
-  vector<int> cartProductIds;
   vector<int> orderIds;
 
 public:
@@ -27,18 +26,11 @@ public:
 
   // Customer features
   void browseProducts();
-  void addToCart(int productId);
-  void removeFromCart(int productId);
-  void viewCart() const;
-  void clearCart();
-  void placeOrder();
   void viewOrderHistory() const;
 
   // Getters
   string getAddress() const { return address; }
   string getPhone() const { return phone; }
-  vector<int> getCart() const { return cartProductIds; }
-  int getCartSize() const { return cartProductIds.size(); }
 
   // Setters
   void setAddress(const string &newAddress);
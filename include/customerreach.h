@@ -0,0 +1,111 @@
+#ifndef CUSTOMERREACH_H
+#define CUSTOMERREACH_H
+
+#include "order.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// HYPERLOGLOG SKETCH
+// ============================================
+// Estimates how many distinct values were added using 2^precision
+// one-byte registers. With the default precision of 12 a sketch is 4 KB
+// and the standard error is 1.04 / sqrt(4096) = 1.6% (about 3.2% at two
+// standard deviations), whatever the number of distinct values. Small
+// counts fall back to linear counting and are close to exact.
+//
+// Merging takes the register-wise maximum, so the union of any set of
+// sketches (time windows, worker partials) costs one pass over registers.
+//
+// Most products and months see few customers, so a sketch starts sparse:
+// a sorted list of its non-zero registers, 4 bytes each (index << 8 |
+// rank). Past 2^precision / 4 entries - the size of the dense array - it
+// switches to the dense registers. Both forms hold the same register
+// values, so estimates and merges do not depend on the form. A product
+// with 3 buyers in a month costs 12 bytes; no sketch costs more than
+// 4 KB, so a month costs at most 4 KB per product and category sold.
+
+class HyperLogLog {
+private:
+  uint8_t precision;
+  vector<uint32_t> sparse;   // Sorted non-zero registers while sparse
+  vector<uint8_t> registers; // Dense registers once past the limit
+
+  bool isSparse() const { return registers.empty(); }
+  size_t registerCount() const { return size_t(1) << precision; }
+  void raise(size_t index, uint8_t rank);
+  void toDense();
+
+public:
+  static const uint8_t DEFAULT_PRECISION = 12;
+
+  explicit HyperLogLog(uint8_t precision = DEFAULT_PRECISION);
+
+  void add(uint64_t value);
+  void merge(const HyperLogLog &other);
+  double estimate() const;
+
+  double getStandardError() const;
+  size_t memoryBytes() const {
+    return registers.size() + sparse.size() * sizeof(uint32_t);
+  }
+};
+
+// ============================================
+// CUSTOMER REACH CLASS
+// ============================================
+// Distinct customers per product and per category, one sketch per
+// calendar month ("YYYY-MM", local time) so any run of months can be
+// answered by merging. Built from every non-cancelled order at startup
+// (orders split over worker threads, partial sketches merged) and
+// updated at checkout. A sketch cannot forget a customer, so orders
+// cancelled later stay counted until the next startup. Sketches start
+// sparse (see HyperLogLog), so long-tail products stay a few bytes each.
+
+using ReachRow = pair<string, double>; // Product/category, estimate
+
+class CustomerReach {
+private:
+  using SketchMap = unordered_map<string, HyperLogLog>;
+
+  map<string, SketchMap> productsByMonth;
+  map<string, SketchMap> categoriesByMonth;
+
+  static uint64_t hashCustomer(int customerId);
+  static void addOrder(const Order &order, const ProductLookup &lookup,
+                       map<string, SketchMap> &products,
+                       map<string, SketchMap> &categories);
+  static void mergeInto(map<string, SketchMap> &target,
+                        const map<string, SketchMap> &source);
+  static vector<ReachRow> rank(const map<string, SketchMap> &byMonth,
+                               const string &fromMonth, size_t limit);
+
+public:
+  // ============================================
+  // MAINTENANCE
+  // ============================================
+  // Rebuild from every order on up to `threads` workers (0 = hardware)
+  void build(const vector<Order> &orders, const ProductLookup &lookup,
+             unsigned threads = 0);
+  void orderPlaced(const Order &order, const ProductLookup &lookup);
+
+  // ============================================
+  // QUERIES
+  // ============================================
+  // Months from `fromMonth` ("YYYY-MM", inclusive) up to now; an empty
+  // string means all time
+  vector<ReachRow> topProducts(const string &fromMonth, size_t limit) const;
+  vector<ReachRow> topCategories(const string &fromMonth,
+                                 size_t limit) const;
+
+  size_t getSketchCount() const;
+  size_t memoryBytes() const;
+};
+
+#endif
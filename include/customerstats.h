@@ -0,0 +1,76 @@
+#ifndef CUSTOMERSTATS_H
+#define CUSTOMERSTATS_H
+
+#include "order.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// CUSTOMER TOTALS
+// ============================================
+// One fixed-size record per customer. Cancelled orders still count as
+// placed (and as the last order) but not towards lifetime spend.
+struct CustomerTotals {
+  int32_t orders = 0;
+  int32_t cancelled = 0;
+  int64_t spendCents = 0;  // Charged totals of orders not cancelled
+  int64_t lastOrderAt = 0; // Epoch seconds, 0 if never ordered
+
+  Money getSpend() const { return Money::fromCents(spendCents); }
+};
+
+// ============================================
+// CUSTOMER STATS CLASS
+// ============================================
+// Order count, lifetime spend and last order per customer, updated in
+// O(1) as orders are placed and cancelled. Records are indexed directly
+// by user ID, in memory and in data/customer_stats.bin:
+//
+//   "MXS1"  orders seen (u64)  cancelled (u64)   20-byte header
+//   record for user 0, user 1, ...               24 bytes each
+//
+// so persisting a change rewrites the header and that customer's record
+// in place. The header's order counts show whether the file matches the
+// order list; if not it is rebuilt (orders split over worker threads,
+// per-thread records summed).
+
+class CustomerStats {
+private:
+  static const string STATS_FILE;
+  static const char FORMAT_HEADER[4];
+  static const size_t HEADER_BYTES = 20;
+
+  vector<CustomerTotals> byCustomer; // Indexed by user ID
+  uint64_t orderCount;
+  uint64_t cancelledCount;
+
+  CustomerTotals &totalsFor(int customerId);
+
+public:
+  CustomerStats();
+
+  // ============================================
+  // MAINTENANCE
+  // ============================================
+  void rebuild(const vector<Order> &orders, unsigned threads = 0);
+  void orderPlaced(const Order &order);
+  void orderCancelled(const Order &order);
+  bool matches(size_t orders, size_t cancelled) const;
+
+  // ============================================
+  // STORAGE
+  // ============================================
+  void load(); // Empty stats if nothing saved
+  void save() const;
+  void persist(int customerId) const; // Header + one record
+
+  // ============================================
+  // QUERIES
+  // ============================================
+  const CustomerTotals &get(int customerId) const;
+};
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef FACETINDEX_H
+#define FACETINDEX_H
+
+#include "product.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// ROARING BITMAP
+// ============================================
+// Compressed bitmap of 32-bit slots. Values are grouped by their high
+// 16 bits into containers; a container is a sorted array while sparse and
+// switches to a 65536-bit bitset once it holds more than 4096 values.
+
+class RoaringBitmap {
+private:
+  static constexpr size_t ARRAY_LIMIT = 4096;
+  static constexpr size_t BITSET_WORDS = 1024;
+
+  struct Container {
+    uint16_t key = 0;
+    vector<uint16_t> array; // Sorted values while sparse
+    vector<uint64_t> bits;  // Dense bitset (empty while sparse)
+    size_t cardinality = 0;
+
+    bool isBitset() const { return !bits.empty(); }
+    bool contains(uint16_t low) const;
+    bool add(uint16_t low);
+    bool remove(uint16_t low);
+    void toBitset();
+    void toArray();
+  };
+
+  vector<Container> containers; // Sorted by key
+
+  Container *findContainer(uint16_t key);
+  const Container *findContainer(uint16_t key) const;
+
+  static Container andContainers(const Container &a, const Container &b);
+  static Container orContainers(const Container &a, const Container &b);
+
+public:
+  // ============================================
+  // MUTATION
+  // ============================================
+  void add(uint32_t value);
+  void remove(uint32_t value);
+  void clear() { containers.clear(); }
+
+  // ============================================
+  // QUERIES
+  // ============================================
+  bool contains(uint32_t value) const;
+  size_t cardinality() const;
+  bool isEmpty() const { return containers.empty(); }
+  vector<uint32_t> toVector() const;
+  // Largest value below `below`; false if there is none
+  bool previous(uint32_t below, uint32_t &value) const;
+
+  // ============================================
+  // SET OPERATIONS
+  // ============================================
+  RoaringBitmap operator&(const RoaringBitmap &other) const;
+  RoaringBitmap operator|(const RoaringBitmap &other) const;
+};
+
+// ============================================
+// FACET TYPES
+// ============================================
+enum class StockState { IN_STOCK, LOW_STOCK, OUT_OF_STOCK };
+
+// A facet query ANDs the three dimensions together and ORs the values
+// inside each one. An empty list leaves that dimension unconstrained.
+struct FacetQuery {
+  vector<string> categories;
+  vector<int> priceBands;
+  vector<StockState> stockStates;
+};
+
+struct FacetResult {
+  vector<string> productIds;       // Matches, in catalog order
+  map<string, size_t> categoryCounts;
+  vector<size_t> priceBandCounts;  // Indexed by price band
+  vector<size_t> stockStateCounts; // Indexed by StockState
+};
+
+// ============================================
+// FACET INDEX CLASS
+// ============================================
+// Bitmap indexes over the catalog for category, price band and stock
+// state. Products get a dense slot number; every facet value keeps a
+// bitmap of the slots that carry it.
+
+class FacetIndex {
+private:
+  struct SlotFacets {
+    string category;
+    int priceBand = 0;
+    StockState stockState = StockState::OUT_OF_STOCK;
+    bool live = false;
+  };
+
+  unordered_map<string, uint32_t> slotByProductId;
+  vector<string> productIdBySlot;
+  vector<SlotFacets> slotFacets;
+  vector<uint32_t> freeSlots;
+
+  RoaringBitmap allProducts;
+  map<string, RoaringBitmap> byCategory;
+  vector<RoaringBitmap> byPriceBand;
+  vector<RoaringBitmap> byStockState;
+  int lowStockThreshold; // Low stock below this level, as stock alerts
+
+  void unindexSlot(uint32_t slot);
+  RoaringBitmap categoryFilter(const vector<string> &categories) const;
+  RoaringBitmap priceBandFilter(const vector<int> &priceBands) const;
+  RoaringBitmap stockStateFilter(const vector<StockState> &states) const;
+
+public:
+  explicit FacetIndex(int lowStockThreshold = 10);
+
+  // ============================================
+  // MAINTENANCE
+  // ============================================
+  void rebuild(const vector<Product> &products);
+  void upsert(const Product &product); // Add or re-index one product
+  void remove(const string &productId);
+  // Re-derive every product's stock state against the new threshold
+  void setLowStockThreshold(int threshold, const vector<Product> &products);
+
+  // ============================================
+  // QUERIES
+  // ============================================
+  FacetResult query(const FacetQuery &facetQuery) const;
+  vector<string> getCategories() const;
+  size_t size() const { return allProducts.cardinality(); }
+
+  // ============================================
+  // FACET VALUES
+  // ============================================
+  static int priceBandCount();
+  static int priceBandOf(Money price);
+  static string priceBandLabel(int band);
+  StockState stockStateOf(int quantity) const;
+  static string stockStateLabel(StockState state);
+};
+
+#endif
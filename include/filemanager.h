@@ -5,6 +5,10 @@
 #include "customer.h"
 #include "order.h"
 #include "product.h"
+#include "promotions.h"
+#include "salesrollup.h"
+#include "settings.h"
+#include "warehouse.h"
 #include <memory>
 #include <string>
 #include <vector>
@@ -17,6 +21,11 @@ private:
   static const string PRODUCTS_FILE;
   static const string USERS_FILE;
   static const string ORDERS_FILE;
+  static const string SETTINGS_FILE;
+  static const string WAREHOUSES_FILE;
+  static const string WAREHOUSE_STOCK_FILE;
+  static const string PROMOTIONS_FILE;
+  static const string SALES_ROLLUPS_FILE;
 
 public:
   // Product functions
@@ -40,9 +49,26 @@ public:
   static void saveOrders(const vector<Order> &orders);
   static vector<Order> getCustomerOrders(int customerId);
   static void addOrder(const Order &order);
-  static void updateOrderStatus(const string &orderId, OrderStatus status);
   static string generateOrderId();
 
+  // Settings functions
+  static StoreSettings loadSettings();
+  static void saveSettings(const StoreSettings &settings);
+
+  // Warehouse functions
+  static vector<Warehouse> loadWarehouses();
+  static void saveWarehouses(const vector<Warehouse> &warehouses);
+  static WarehouseStockMap loadWarehouseStock();
+  static void saveWarehouseStock(const WarehouseStockMap &stock);
+
+  // Promotion functions
+  static vector<PromotionRule> loadPromotions();
+  static void savePromotions(const vector<PromotionRule> &rules);
+
+  // Sales rollup functions
+  static SalesRollupTables loadSalesRollups(); // Empty tables if none saved
+  static void saveSalesRollups(const SalesRollupTables &tables);
+
   // Utility
   static bool fileExists(const string &filename);
   static void ensureDataDirectory();
@@ -0,0 +1,96 @@
+#ifndef FLASHSALE_H
+#define FLASHSALE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+using namespace std;
+
+// ============================================
+// FLASH SALE POOL CLASS
+// ============================================
+// Stock for one hot product split into per-core sub-pools, each on its
+// own cache line. A thread takes units from its home sub-pool; when that
+// runs dry it steals half of another sub-pool, and only if that fails
+// does it gather units pool by pool. Every take is a compare-and-swap
+// that never lets a sub-pool go negative, so the sum can never oversell.
+// Reserved units are counted per sub-pool too, so the hot path never
+// touches a counter shared by all cores.
+
+class FlashSalePool {
+private:
+  struct alignas(64) SubPool {
+    atomic<int> units{0};
+    atomic<int> reserved{0};
+  };
+
+  unique_ptr<SubPool[]> pools;
+  size_t poolCount;
+
+  size_t homePool() const;
+  bool takeFrom(size_t pool, int quantity);
+  bool stealInto(size_t home, int quantity);
+
+public:
+  // ============================================
+  // CONSTRUCTORS
+  // ============================================
+  explicit FlashSalePool(size_t poolCount = 0); // 0 = one per core
+
+  // ============================================
+  // STOCK
+  // ============================================
+  bool take(int quantity);         // Moves units from free to reserved
+  void commit(int quantity);       // Reserved units were sold
+  void release(int quantity);      // Reserved units go back on sale
+  void give(int quantity);         // Free units to the caller's home pool
+  void distribute(int quantity);   // Free units spread over all pools
+  int drain();                     // Empty every pool, return the units
+
+  // ============================================
+  // GETTERS
+  // ============================================
+  int total() const; // Free units
+  int reservedTotal() const;
+  size_t getPoolCount() const { return poolCount; }
+};
+
+// ============================================
+// TOKEN BUCKET CLASS
+// ============================================
+// Lock-free admission gate allowing `ratePerSecond` requests with bursts
+// of up to `burst`. Implemented as GCRA: one atomic "theoretical arrival
+// time" replaces the token count, so admitting is a single CAS.
+
+class TokenBucket {
+private:
+  atomic<int64_t> theoreticalArrival; // Nanoseconds, steady clock
+  atomic<int64_t> interval;           // Nanoseconds per token
+  atomic<int64_t> burstTolerance;     // interval * (burst - 1)
+  atomic<uint64_t> admitted;
+  atomic<uint64_t> rejected;
+
+  static int64_t nowNanos();
+
+public:
+  // ============================================
+  // CONSTRUCTORS
+  // ============================================
+  TokenBucket(int ratePerSecond, int burst);
+  void configure(int ratePerSecond, int burst);
+
+  // ============================================
+  // ADMISSION
+  // ============================================
+  bool tryAdmit();
+
+  // ============================================
+  // GETTERS
+  // ============================================
+  uint64_t getAdmitted() const { return admitted.load(); }
+  uint64_t getRejected() const { return rejected.load(); }
+};
+
+#endif
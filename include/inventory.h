@@ -0,0 +1,157 @@
+#ifndef INVENTORY_H
+#define INVENTORY_H
+
+#include "flashsale.h"
+#include "product.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// STOCK RESERVATION STRUCT
+// ============================================
+// Units taken out of `available` for one product. A reservation must be
+// either committed (the units are sold) or released (they go back).
+struct StockReservation {
+  string productId;
+  int slot;
+  int quantity;
+  bool fromFlashSale = false; // Taken from the product's flash-sale pool
+};
+
+struct FlashSaleStats {
+  int available = 0;
+  size_t pools = 0;
+  uint64_t admitted = 0;
+  uint64_t rejected = 0;
+};
+
+// ============================================
+// INVENTORY ENGINE CLASS
+// ============================================
+// In-memory stock counters for concurrent checkouts. Every product has
+// its own cache-line sized pair of atomics:
+//   available - units that can still be promised to a buyer
+//   reserved  - units held by reservations not yet committed/released
+// so on-hand stock is available + reserved. Reserving is a compare-and-
+// swap loop on `available` and never oversells; checkouts touching
+// different products never share a cache line or a lock.
+//
+// Counters live in fixed-size chunks that are never moved or freed, so
+// a slot can be read without locking. The productId -> slot map is an
+// immutable snapshot behind an atomic pointer: lookups never lock, and
+// registering a product publishes a new copy under a writer-only mutex.
+// A lookup marks itself in one of several striped reader counters while
+// it holds a snapshot; after publishing, the writer frees the snapshots
+// it replaced as soon as it sees every stripe at zero, so at most the
+// current map plus those replaced while readers were busy stay alive.
+//
+// A product in flash-sale mode moves its available units into a
+// FlashSalePool of per-core sub-pools and gets a TokenBucket admission
+// gate, so a single hot product no longer funnels every checkout through
+// one counter (flash reservations are counted in the sub-pools too).
+
+class InventoryEngine {
+private:
+  // Created the first time a product goes on flash sale and kept for the
+  // engine's lifetime, so a checkout never sees it freed under it
+  struct FlashSale {
+    FlashSalePool pool;
+    TokenBucket gate;
+    atomic<bool> active{false};
+    FlashSale(int ratePerSecond, int burst) : gate(ratePerSecond, burst) {}
+  };
+
+  struct alignas(64) StockCounter {
+    atomic<int> available{0};
+    atomic<int> reserved{0};
+    atomic<FlashSale *> flashSale{nullptr};
+  };
+
+  using Registry = unordered_map<string, int>;
+
+  static constexpr size_t CHUNK_SIZE = 256;
+  static constexpr size_t MAX_CHUNKS = 1024;
+
+  unique_ptr<StockCounter[]> chunks[MAX_CHUNKS];
+  atomic<size_t> slotCount;
+
+  static constexpr size_t READER_STRIPES = 16;
+
+  struct alignas(64) ReaderStripe {
+    atomic<int> active{0};
+  };
+
+  // Replaced snapshots wait in registryVersions (current one last) until
+  // no reader can still be walking them
+  atomic<const Registry *> registry;
+  vector<unique_ptr<const Registry>> registryVersions;
+  mutable ReaderStripe readers[READER_STRIPES];
+  mutable mutex writerMutex; // Serialises registration and flash-sale creation
+
+  vector<unique_ptr<FlashSale>> flashSales;
+
+  StockCounter &counter(int slot) const;
+  // Both called with writerMutex held
+  int registerSlots(const vector<string> &productIds);
+  void reclaimRegistries();
+  static size_t readerStripe();
+  FlashSale *activeFlashSale(const StockCounter &c) const;
+
+public:
+  // ============================================
+  // CONSTRUCTORS
+  // ============================================
+  InventoryEngine();
+
+  InventoryEngine(const InventoryEngine &) = delete;
+  InventoryEngine &operator=(const InventoryEngine &) = delete;
+
+  // ============================================
+  // CATALOG SYNC
+  // ============================================
+  void load(const vector<Product> &products);
+  void setOnHand(const string &productId, int quantity);
+  void removeProduct(const string &productId);
+
+  // ============================================
+  // FLASH SALES
+  // ============================================
+  void startFlashSale(const string &productId, int ratePerSecond, int burst);
+  void endFlashSale(const string &productId);
+  bool isFlashSale(const string &productId) const;
+  bool admit(const string &productId); // Always true outside flash sales
+  FlashSaleStats getFlashSaleStats(const string &productId) const;
+
+  // ============================================
+  // RESERVATIONS
+  // ============================================
+  int slotOf(const string &productId) const; // -1 if unknown
+  bool tryReserve(const string &productId, int quantity,
+                  StockReservation &reservation);
+  void commit(const StockReservation &reservation);
+  void release(const StockReservation &reservation);
+
+  // All-or-nothing reservation for a whole cart: either every line is
+  // reserved or none is (throws InsufficientStockException)
+  vector<StockReservation>
+  reserveAll(const vector<pair<string, int>> &lines);
+  void commitAll(const vector<StockReservation> &reservations);
+  void releaseAll(const vector<StockReservation> &reservations);
+
+  // ============================================
+  // GETTERS
+  // ============================================
+  int getAvailable(const string &productId) const;
+  int getReserved(const string &productId) const;
+  int getOnHand(const string &productId) const;
+  size_t getRegistryVersionCount() const; // Snapshots still allocated
+};
+
+#endif
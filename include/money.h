@@ -0,0 +1,65 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// ============================================
+// MONEY CLASS
+// ============================================
+// Fixed-point currency amount stored as a whole number of cents, so
+// sums and comparisons are exact (no floating point drift).
+
+class Money {
+private:
+  int64_t cents;
+
+public:
+  // ============================================
+  // CONSTRUCTORS
+  // ============================================
+  Money() : cents(0) {}
+  static Money fromCents(int64_t cents);
+  static Money fromDouble(double amount); // Rounds to the nearest cent
+  static Money parse(const string &text); // "12.34", "$12.34", "12"
+
+  // ============================================
+  // CONVERSION & DISPLAY
+  // ============================================
+  int64_t getCents() const { return cents; }
+  double toDouble() const { return cents / 100.0; }
+  string toString() const; // "1299.99"
+  string format() const { return "$" + toString(); }
+
+  // ============================================
+  // ARITHMETIC
+  // ============================================
+  Money operator+(const Money &other) const;
+  Money operator-(const Money &other) const;
+  Money operator*(int64_t factor) const;
+  Money percentOf(int percent) const; // Rounded half up to the cent
+  Money &operator+=(const Money &other);
+  Money &operator-=(const Money &other);
+
+  // ============================================
+  // COMPARISON OPERATORS
+  // ============================================
+  bool operator==(const Money &other) const { return cents == other.cents; }
+  bool operator!=(const Money &other) const { return cents != other.cents; }
+  bool operator<(const Money &other) const { return cents < other.cents; }
+  bool operator<=(const Money &other) const { return cents <= other.cents; }
+  bool operator>(const Money &other) const { return cents > other.cents; }
+  bool operator>=(const Money &other) const { return cents >= other.cents; }
+
+  // ============================================
+  // BULK TOTALS
+  // ============================================
+  // Sum of a cents array. Integer addition is associative, so the
+  // unrolled, vectorisable loop gives the same result as a plain one.
+  static Money sum(const int64_t *cents, size_t count);
+};
+
+#endif
@@ -2,7 +2,7 @@
 #define ORDER_H
 
 #include "cart.h"
-#include <ctime>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -20,16 +20,19 @@ enum class OrderStatus {
   CANCELLED
 };
 
+constexpr size_t ORDER_STATUS_COUNT = 6;
+
 // ============================================
 // ORDER ITEM STRUCT
 // ============================================
 struct OrderItem {
   string productId;
   string productName;
-  double price;
+  string category; // At the time of the order (empty in older orders)
+  Money price;
   int quantity;
 
-  double getSubtotal() const { return price * quantity; }
+  Money getSubtotal() const { return price * quantity; }
 };
 
 // ============================================
@@ -40,24 +43,36 @@ private:
   string id;      // Order ID (e.g., "ORD001")
   int customerId; // Customer who placed the order
   vector<OrderItem> items;
-  double totalAmount;
+  Money totalAmount;    // After discounts
+  Money discountAmount; // Promotions and coupon, already taken off
+  string couponCode;    // Coupon used at checkout (empty if none)
   OrderStatus status;
-  string createdAt; // Timestamp
-  string updatedAt; // Last update timestamp
+  int64_t createdAt; // Epoch seconds
+  int64_t updatedAt; // Epoch seconds of the last status change
 
 public:
   // ============================================
   // CONSTRUCTORS
   // ============================================
   Order();
-  Order(const string &id, int customerId, const vector<OrderItem> &items,
-        double total);
+  Order(const string &id, int customerId, vector<OrderItem> items,
+        Money total);
 
   // ============================================
   // FACTORY METHOD
   // ============================================
   static Order createFromCart(const string &orderId, int customerId,
-                              const Cart &cart);
+                              const Cart &cart, const ProductLookup &lookup);
+  static Money computeTotal(const vector<OrderItem> &items);
+
+  // Rebuild a saved order exactly as stored - no timestamp is touched
+  static Order restore(const string &id, int customerId,
+                       vector<OrderItem> items, Money total,
+                       OrderStatus status, int64_t createdAt,
+                       int64_t updatedAt);
+
+  // Record the promotion discount; the total becomes items minus discount
+  void setDiscount(Money discount, const string &coupon);
 
   // ============================================
   // DISPLAY
@@ -68,27 +83,34 @@ public:
   // ============================================
   // STATUS MANAGEMENT
   // ============================================
+  // Lifecycle: Pending -> Confirmed -> Processing -> Shipped -> Delivered,
+  // with Cancelled reachable until the order ships. Delivered and
+  // Cancelled are final. Throws InvalidInputException for any other move.
   void updateStatus(OrderStatus newStatus);
+  static bool canTransition(OrderStatus from, OrderStatus to);
+  static vector<OrderStatus> nextStatuses(OrderStatus from);
   static string statusToString(OrderStatus status);
   static OrderStatus stringToStatus(const string &statusStr);
+  // Case-insensitive match on a status name; false if there is none
+  static bool parseStatus(const string &text, OrderStatus &status);
 
   // ============================================
   // GETTERS
   // ============================================
   string getId() const { return id; }
   int getCustomerId() const { return customerId; }
-  vector<OrderItem> getItems() const { return items; }
-  double getTotalAmount() const { return totalAmount; }
+  const vector<OrderItem> &getItems() const { return items; }
+  Money getTotalAmount() const { return totalAmount; }
+  Money getDiscountAmount() const { return discountAmount; }
+  string getCouponCode() const { return couponCode; }
   OrderStatus getStatus() const { return status; }
   string getStatusString() const { return statusToString(status); }
-  string getCreatedAt() const { return createdAt; }
-  string getUpdatedAt() const { return updatedAt; }
+  int64_t getCreatedAt() const { return createdAt; }
+  int64_t getUpdatedAt() const { return updatedAt; }
+  string getCreatedAtString() const {
+    return Utils::formatTimestamp(createdAt);
+  }
   int getItemCount() const { return items.size(); }
-
-  // ============================================
-  // UTILITY
-  // ============================================
-  static string getCurrentTimestamp();
 };
 
 #endif
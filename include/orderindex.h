@@ -0,0 +1,129 @@
+#ifndef ORDERINDEX_H
+#define ORDERINDEX_H
+
+#include "facetindex.h"
+#include "order.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// ORDER QUERY TYPES
+// ============================================
+// Every set field narrows the result; an unset field matches all orders.
+// Date and total bounds are inclusive.
+struct OrderQuery {
+  vector<OrderStatus> statuses; // Any of these (empty = any status)
+  int customerId = 0;           // 0 = any customer
+
+  bool filterDates = false;
+  int64_t createdFrom = 0; // Epoch seconds
+  int64_t createdTo = 0;
+
+  bool filterTotals = false;
+  Money minTotal;
+  Money maxTotal;
+};
+
+// Keyset cursor - the slot of the last order on the previous page
+struct OrderCursor {
+  uint32_t slot = 0;
+  bool atStart = true;
+};
+
+// ============================================
+// ORDER INDEX CLASS
+// ============================================
+// Secondary indexes over the order list, which is append-only: an
+// order's slot is its position in Application::orders. Status and
+// customer map to bitmaps of slots; creation time and total are sorted
+// (key, slot) arrays, so a range becomes a binary search plus a bitmap.
+// count() ANDs the bitmaps of the fields a query sets. Pages come newest
+// first (highest slot first) and are keyed by slot: a page walks down
+// from the cursor through the narrowest filter - the customer's bitmap,
+// the wanted status bitmaps, the slots of the total range, or the date
+// window - and checks the other fields per slot, so it only touches the
+// slots it steps over, never the full match set.
+//
+// Orders are appended as they are created, so creation times normally
+// rise with the slot and a date range is a window of slots found by
+// binary search; the walk starts at the window's top and stops at its
+// bottom. If imported orders break that order, dates fall back to the
+// sorted (time, slot) array like totals.
+//
+// Each status also keeps an intrusive FIFO queue - prev/next links
+// stored per slot - and a live count. An order joins the tail of its
+// status queue when it enters that status, so the head is the order that
+// has waited longest and counts never need a scan.
+
+class OrderIndex {
+private:
+  using KeyedSlots = vector<pair<int64_t, uint32_t>>; // Sorted by key
+
+  static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+  struct StatusQueue {
+    uint32_t head = NO_SLOT; // Longest in this status
+    uint32_t tail = NO_SLOT;
+    size_t count = 0;
+  };
+
+  unordered_map<string, uint32_t> slotById;
+  vector<OrderStatus> statusBySlot;
+  vector<int> customerBySlot;
+  vector<int64_t> createdAtBySlot;
+  vector<int64_t> totalCentsBySlot;
+  vector<RoaringBitmap> byStatus; // Indexed by OrderStatus
+  unordered_map<int, RoaringBitmap> byCustomer;
+  KeyedSlots byCreatedAt;
+  KeyedSlots byTotalCents;
+  bool createdInSlotOrder; // createdAtBySlot never decreases
+
+  vector<StatusQueue> queues; // Indexed by OrderStatus
+  vector<uint32_t> prevInQueue;
+  vector<uint32_t> nextInQueue;
+
+  void enqueue(uint32_t slot, OrderStatus status);
+  void unlink(uint32_t slot, OrderStatus status);
+
+  static void insertSorted(KeyedSlots &index, int64_t key, uint32_t slot);
+  static RoaringBitmap rangeOf(const KeyedSlots &index, int64_t low,
+                               int64_t high);
+  static size_t rangeSize(const KeyedSlots &index, int64_t low, int64_t high);
+
+  // Matching slots; `filtered` is false when the query matches everything
+  RoaringBitmap match(const OrderQuery &query, bool &filtered) const;
+  bool matchesSlot(const OrderQuery &query, uint32_t slot) const;
+
+public:
+  OrderIndex();
+
+  // ============================================
+  // MAINTENANCE
+  // ============================================
+  void rebuild(const vector<Order> &orders);
+  void add(const Order &order, uint32_t slot);
+  void updateStatus(const string &orderId, OrderStatus newStatus);
+
+  // ============================================
+  // QUERIES
+  // ============================================
+  int find(const string &orderId) const; // Slot, or -1 if unknown
+  size_t size() const { return statusBySlot.size(); }
+  size_t count(const OrderQuery &query) const;
+
+  // O(1) status dashboard reads
+  size_t countByStatus(OrderStatus status) const;
+  int oldestIn(OrderStatus status) const; // Slot, or -1 if none
+
+  // One page of slots after the cursor, newest first; `next` is set to
+  // the cursor for the following page
+  vector<uint32_t> page(const OrderQuery &query, const OrderCursor &after,
+                        size_t limit, OrderCursor &next) const;
+};
+
+#endif
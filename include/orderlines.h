@@ -0,0 +1,91 @@
+#ifndef ORDERLINES_H
+#define ORDERLINES_H
+
+#include "order.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// QUERY TYPES
+// ============================================
+enum class LineGroupBy { PRODUCT, CUSTOMER };
+
+// Row filter; bounds are inclusive, unset fields match every line
+struct LineFilter {
+  int64_t from = INT64_MIN; // Epoch seconds
+  int64_t to = INT64_MAX;
+  int32_t customerId = 0;   // 0 = any customer
+  bool excludeCancelled = true;
+};
+
+struct LineGroup {
+  int64_t key = 0; // Product code or customer ID
+  int64_t revenueCents = 0;
+  int64_t units = 0;
+  int64_t lines = 0;
+};
+
+// ============================================
+// ORDER LINE STORE CLASS
+// ============================================
+// Column-oriented copy of every order line for ad-hoc analysis. Each
+// field is its own contiguous array, and product IDs are replaced by
+// dense dictionary codes, so a scan reads only the columns a query
+// needs, 4-8 bytes per row.
+//
+// aggregate() splits the rows over worker threads. Each thread filters
+// blocks of rows with branch-free arithmetic (a loop the compiler can
+// vectorise) into a small buffer, then adds the buffer into its own
+// partial groups; partials are merged at the end.
+
+class OrderLineStore {
+private:
+  // Columns (one entry per order line)
+  vector<uint32_t> orderCodes;
+  vector<int32_t> customerIds;
+  vector<uint32_t> productCodes;
+  vector<int32_t> quantities;
+  vector<int64_t> priceCents;
+  vector<int64_t> timestamps;
+  vector<uint8_t> cancelled;
+
+  // Dictionaries
+  vector<string> orderIds; // By order code
+  vector<string> productIds; // By product code
+  unordered_map<string, uint32_t> productCodeById;
+
+  uint32_t productCode(const string &productId);
+  void aggregateRange(const LineFilter &filter, LineGroupBy groupBy,
+                      size_t begin, size_t end,
+                      unordered_map<int64_t, LineGroup> &groups) const;
+
+public:
+  // ============================================
+  // LOADING
+  // ============================================
+  void clear();
+  void reserve(size_t lines);
+  void append(const Order &order);
+  void appendLine(const string &orderId, int32_t customerId,
+                  const string &productId, int32_t quantity,
+                  int64_t priceCents, int64_t timestamp, bool isCancelled);
+  void build(const vector<Order> &orders);
+
+  // ============================================
+  // QUERIES
+  // ============================================
+  size_t size() const { return quantities.size(); }
+  size_t getOrderCount() const { return orderIds.size(); }
+  size_t memoryBytes() const;
+  const string &productIdOf(uint32_t code) const { return productIds[code]; }
+
+  // Filtered group-by sums and counts, largest revenue first
+  vector<LineGroup> aggregate(const LineFilter &filter, LineGroupBy groupBy,
+                              unsigned threads = 0) const;
+};
+
+#endif
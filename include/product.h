@@ -1,6 +1,7 @@
 #ifndef PRODUCT_H
 #define PRODUCT_H
 
+#include "money.h"
 #include "utils.h"
 #include <iostream>
 #include <string>
@@ -18,7 +19,7 @@ private:
   string name;        // Product name
   string category;    // Product category
   string description; // Product description
-  double price;       // Product price
+  Money price;        // Product price
   int quantity;       // Stock quantity
 
 public:
@@ -27,13 +28,13 @@ public:
   // ============================================
   Product();
   Product(const string &id, const string &name, const string &category,
-          const string &description, double price, int quantity);
+          const string &description, Money price, int quantity);
 
   // ============================================
   // DISPLAY METHODS
   // ============================================
-  void displayInfo() const;
-  void displayShort() const; // One-line display for listings
+  void displayInfo(int lowStockThreshold) const; // "Low!" below threshold
+  void displayShort(int held = 0) const; // One-line display for listings
 
   // ============================================
   // STOCK MANAGEMENT
@@ -50,7 +51,7 @@ public:
   string getName() const { return name; }
   string getCategory() const { return category; }
   string getDescription() const { return description; }
-  double getPrice() const { return price; }
+  Money getPrice() const { return price; }
   int getQuantity() const { return quantity; }
 
   // ============================================
@@ -59,7 +60,7 @@ public:
   void setName(const string &newName);
   void setCategory(const string &newCategory);
   void setDescription(const string &newDescription);
-  void setPrice(double newPrice);
+  void setPrice(Money newPrice);
   void setQuantity(int newQuantity);
 
   // ============================================
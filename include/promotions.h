@@ -0,0 +1,115 @@
+#ifndef PROMOTIONS_H
+#define PROMOTIONS_H
+
+#include "cart.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// PROMOTION RULE TYPES
+// ============================================
+enum class PromotionType { CATEGORY_DISCOUNT, BUY_X_GET_Y, TIERED, COUPON };
+
+struct PriceTier {
+  int minQuantity;
+  int percent; // Discount once the line reaches minQuantity units
+};
+
+// One rule as written in data/promotions.json. A rule targets either a
+// product or a category; coupons apply to the whole cart.
+struct PromotionRule {
+  string id;
+  PromotionType type = PromotionType::CATEGORY_DISCOUNT;
+  string description;
+  bool active = true;
+
+  string productId; // BUY_X_GET_Y, TIERED
+  string category;  // CATEGORY_DISCOUNT, TIERED
+
+  int percent = 0;       // CATEGORY_DISCOUNT, COUPON
+  int buyQuantity = 0;   // BUY_X_GET_Y: pay for this many...
+  int freeQuantity = 0;  // ...and get this many free
+  vector<PriceTier> tiers;
+
+  string couponCode;  // COUPON
+  Money amountOff;    // COUPON: fixed amount instead of a percent
+  Money minSubtotal;  // COUPON: only on carts at least this big
+};
+
+// ============================================
+// PRICED CART
+// ============================================
+struct PricedLine {
+  string productId;
+  int quantity = 0;
+  Money subtotal; // Before discounts
+  Money discount;
+  string ruleId;  // Rule that produced the discount (empty if none)
+};
+
+struct PricedCart {
+  vector<PricedLine> lines;
+  Money subtotal;
+  Money lineDiscounts;
+  Money couponDiscount;
+  string couponRuleId; // Empty when no coupon applied
+  Money total;
+
+  Money getDiscount() const { return lineDiscounts + couponDiscount; }
+};
+
+// ============================================
+// PROMOTION ENGINE CLASS
+// ============================================
+// Rules are compiled once, when loaded, into lookup tables keyed by
+// product ID, by category and by coupon code. Pricing a line only looks
+// at the rules filed under its product and its category; the best one
+// wins (line discounts do not stack). A coupon is then applied to the
+// discounted subtotal. Tier lists are sorted so the first tier that
+// fits is the best one.
+//
+// A compiled engine is read-only, so many carts can be priced at once;
+// repriceAll splits a batch of carts over worker threads.
+
+class PromotionEngine {
+private:
+  vector<PromotionRule> rules;
+  unordered_map<string, vector<uint32_t>> rulesByProduct;
+  unordered_map<string, vector<uint32_t>> rulesByCategory;
+  unordered_map<string, uint32_t> couponsByCode; // Upper-case codes
+
+  Money lineDiscount(const PromotionRule &rule, const CartItem &item) const;
+  Money couponDiscount(const PromotionRule &rule, Money subtotal) const;
+
+public:
+  // ============================================
+  // COMPILATION
+  // ============================================
+  void compile(const vector<PromotionRule> &newRules);
+  const vector<PromotionRule> &getRules() const { return rules; }
+  static string normalizeCode(const string &code);
+
+  // ============================================
+  // PRICING
+  // ============================================
+  // Throws InvalidInputException for an unknown or inapplicable coupon
+  PricedCart price(const Cart &cart, const ProductLookup &lookup,
+                   const string &couponCode = "") const;
+
+  // Price many carts on up to `threads` workers (0 = hardware threads)
+  vector<PricedCart> repriceAll(const vector<const Cart *> &carts,
+                                const ProductLookup &lookup,
+                                unsigned threads = 0) const;
+
+  // ============================================
+  // RULE TYPES
+  // ============================================
+  static string typeToString(PromotionType type);
+  static PromotionType stringToType(const string &typeStr);
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef RECOMMENDATIONS_H
+#define RECOMMENDATIONS_H
+
+#include "order.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// RECOMMENDATION TYPES
+// ============================================
+struct Neighbour {
+  string productId;
+  uint32_t count; // Orders that contained both products
+};
+
+// ============================================
+// CO-PURCHASE RECOMMENDER CLASS
+// ============================================
+// "Frequently bought together" from order history. Two products co-occur
+// once for every order that contains both. The full sparse co-occurrence
+// matrix only lives in memory; what is served (and saved) is the top-k
+// neighbours of each product, so a recommendation is one hash lookup.
+//
+// data/recommendations.txt holds those lists in a compact text format,
+// stamped with the number of orders they were built from:
+//
+//   MXR1 42 5
+//   P001 P004:7 P002:3
+//
+// While the stamp matches the order list the file is served as-is and
+// the matrix is not built at all. It is built (on worker threads, one
+// partial pair map each) the first time a new order has to be counted;
+// after that each order only touches the pairs it contains and re-ranks
+// the products it contains.
+
+class CoPurchaseRecommender {
+private:
+  static const string RECOMMENDATIONS_FILE;
+  static const string FORMAT_HEADER;
+
+  size_t topK;
+  size_t orderCount; // Orders counted into the lists
+  unordered_map<string, vector<Neighbour>> neighbours;
+
+  // Full matrix over dense product codes; empty until first needed
+  bool matrixBuilt;
+  vector<string> productByCode;
+  unordered_map<string, uint32_t> codeByProduct;
+  vector<unordered_map<uint32_t, uint32_t>> matrix;
+
+  uint32_t codeOf(const string &productId);
+  vector<uint32_t> orderCodes(const Order &order);
+  void rank(uint32_t code);
+
+public:
+  explicit CoPurchaseRecommender(size_t topK = 5);
+
+  // ============================================
+  // BUILDING
+  // ============================================
+  // Rebuild everything from the order list on up to `threads` workers
+  // (0 = hardware threads)
+  void build(const vector<Order> &orders, unsigned threads = 0);
+  // Count one new order; `orders` (which already holds it) is only read
+  // if the matrix has not been built yet this run
+  void orderPlaced(const Order &order, const vector<Order> &orders);
+
+  // ============================================
+  // STORAGE
+  // ============================================
+  // False (and nothing loaded) if there is no file or it was built from
+  // a different number of orders
+  bool load(size_t expectedOrders);
+  void save() const;
+
+  // ============================================
+  // SERVING
+  // ============================================
+  const vector<Neighbour> &recommend(const string &productId) const;
+  size_t getProductCount() const { return neighbours.size(); }
+  size_t getOrderCount() const { return orderCount; }
+};
+
+#endif
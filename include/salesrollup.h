@@ -0,0 +1,77 @@
+#ifndef SALESROLLUP_H
+#define SALESROLLUP_H
+
+#include "order.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// ROLLUP TYPES
+// ============================================
+struct RollupRow {
+  Money revenue;
+  int64_t units = 0;
+  int64_t orders = 0; // Orders contributing to this row
+};
+
+// Everything persisted in data/sales_rollups.json. The order counts
+// record which order list the tables were built from, so a stale file
+// is detected and rebuilt at startup.
+struct SalesRollupTables {
+  map<string, RollupRow> days; // "YYYY-MM-DD" (local date placed)
+  map<string, RollupRow> products;
+  map<string, RollupRow> categories;
+  size_t orderCount = 0;     // Orders seen
+  size_t cancelledCount = 0; // Of which cancelled (not counted)
+};
+
+// ============================================
+// SALES ROLLUP CLASS
+// ============================================
+// Materialised sales totals per day, product and category, kept up to
+// date as orders are placed and cancelled, so reports read a handful of
+// pre-aggregated rows instead of scanning every order line.
+//
+// Day rows hold what customers were charged (order totals, after
+// discounts). Product and category rows hold line revenue at list price,
+// since a coupon is not tied to any one line. Cancelled orders are
+// subtracted again.
+
+class SalesRollup {
+private:
+  SalesRollupTables tables;
+
+  static void add(RollupRow &row, Money revenue, int64_t units,
+                  int64_t orders);
+  void apply(const Order &order, int sign, const ProductLookup &lookup);
+
+public:
+  // ============================================
+  // MAINTENANCE
+  // ============================================
+  void load(const SalesRollupTables &saved) { tables = saved; }
+  const SalesRollupTables &getTables() const { return tables; }
+  bool matches(size_t orderCount, size_t cancelledCount) const;
+  void rebuild(const vector<Order> &orders, const ProductLookup &lookup);
+
+  // Lookup resolves categories for orders saved before they were stored
+  void orderPlaced(const Order &order, const ProductLookup &lookup);
+  void orderCancelled(const Order &order, const ProductLookup &lookup);
+
+  // ============================================
+  // REPORTS
+  // ============================================
+  // Most recent `limit` days, newest first
+  vector<pair<string, RollupRow>> recentDays(size_t limit) const;
+  // Top `limit` products/categories by revenue
+  vector<pair<string, RollupRow>> topProducts(size_t limit) const;
+  vector<pair<string, RollupRow>> topCategories(size_t limit) const;
+  RollupRow getTotals() const;
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef SEARCHCACHE_H
+#define SEARCHCACHE_H
+
+#include "facetindex.h"
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// SEARCH CACHE STATS
+// ============================================
+struct SearchCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+  uint64_t invalidations = 0; // Entries dropped for an old catalog version
+  size_t entries = 0;
+  size_t bytes = 0; // Approximate memory held by cached entries
+
+  double hitRate() const {
+    uint64_t lookups = hits + misses;
+    return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+  }
+};
+
+// ============================================
+// SEARCH CACHE CLASS
+// ============================================
+// Bounded LRU cache of search results. The key is the normalised query
+// plus the filter set; every entry remembers the catalog version it was
+// computed against and is discarded on lookup once the catalog moves on.
+
+class SearchCache {
+private:
+  struct Entry {
+    string key;
+    uint64_t catalogVersion;
+    vector<string> productIds;
+    size_t bytes;
+  };
+
+  size_t capacity;
+  list<Entry> lru; // Most recently used at the front
+  unordered_map<string, list<Entry>::iterator> index;
+  SearchCacheStats stats;
+
+  void erase(list<Entry>::iterator it);
+  static size_t entryBytes(const Entry &entry);
+
+public:
+  // ============================================
+  // CONSTRUCTORS
+  // ============================================
+  explicit SearchCache(size_t capacity = 256);
+
+  // ============================================
+  // KEYS
+  // ============================================
+  static string normalizeQuery(const string &query);
+  static string makeKey(const string &query, const FacetQuery &filters);
+
+  // ============================================
+  // CACHE OPERATIONS
+  // ============================================
+  bool lookup(const string &key, uint64_t catalogVersion,
+              vector<string> &productIds);
+  void store(const string &key, uint64_t catalogVersion,
+             const vector<string> &productIds);
+  void clear();
+
+  // ============================================
+  // GETTERS
+  // ============================================
+  SearchCacheStats getStats() const { return stats; }
+  size_t getCapacity() const { return capacity; }
+};
+
+#endif
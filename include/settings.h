@@ -0,0 +1,25 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// STORE SETTINGS STRUCT
+// ============================================
+// Admin-configurable options, persisted in data/settings.json
+struct StoreSettings {
+  bool cartHoldsEnabled = false; // Hold stock for items sitting in carts
+  int cartHoldTtlSeconds = 900;  // How long a cart hold lasts
+
+  // Flash sale mode: sharded stock plus a checkout admission gate
+  vector<string> flashSaleProductIds;
+  int flashSaleRatePerSecond = 50; // Checkouts admitted per second
+  int flashSaleBurst = 100;        // Checkouts admitted at once
+
+  int lowStockThreshold = 10; // Stock alerts fire below this level
+};
+
+#endif
@@ -0,0 +1,182 @@
+#ifndef SORTEDINDEX_H
+#define SORTEDINDEX_H
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// SORTED INDEX TEMPLATE
+// ============================================
+// Ordered secondary index from a key (price, name, ...) to product IDs.
+// Entries live in one sorted vector ordered by (key, productId). Updates
+// are buffered and merged into the vector in a single pass the next time
+// the index is read, so a burst of stock/price edits costs one merge.
+// Reads are a binary search plus a walk over the requested page.
+
+template <typename Key> class SortedIndex {
+public:
+  struct Entry {
+    Key key;
+    string productId;
+
+    bool operator<(const Entry &other) const {
+      if (key < other.key)
+        return true;
+      if (other.key < key)
+        return false;
+      return productId < other.productId;
+    }
+  };
+
+  // Keyset cursor - the last entry of the previous page
+  struct Cursor {
+    Key key{};
+    string productId;
+    bool atStart = true;
+  };
+
+private:
+  mutable vector<Entry> entries;              // Sorted, merged entries
+  mutable vector<Entry> pending;              // Inserts not merged yet
+  mutable unordered_set<string> staleIds;     // Entries to drop on merge
+  unordered_map<string, Key> currentKey;      // productId -> live key
+
+  void merge() const {
+    if (pending.empty() && staleIds.empty())
+      return;
+
+    vector<Entry> kept;
+    kept.reserve(entries.size());
+    for (Entry &e : entries) {
+      if (staleIds.count(e.productId) == 0)
+        kept.push_back(move(e));
+    }
+
+    sort(pending.begin(), pending.end());
+    entries.clear();
+    entries.reserve(kept.size() + pending.size());
+    std::merge(make_move_iterator(kept.begin()), make_move_iterator(kept.end()),
+               make_move_iterator(pending.begin()),
+               make_move_iterator(pending.end()), back_inserter(entries));
+
+    pending.clear();
+    staleIds.clear();
+  }
+
+  // Index of the first entry after the cursor in the given direction
+  size_t startPosition(const Cursor &after, bool descending) const {
+    if (after.atStart)
+      return 0;
+
+    Entry probe{after.key, after.productId};
+    if (!descending) {
+      return upper_bound(entries.begin(), entries.end(), probe) -
+             entries.begin();
+    }
+    // Walking backwards: count entries strictly below the cursor
+    size_t below =
+        lower_bound(entries.begin(), entries.end(), probe) - entries.begin();
+    return entries.size() - below;
+  }
+
+public:
+  // ============================================
+  // MAINTENANCE
+  // ============================================
+  void rebuild(vector<Entry> newEntries) {
+    sort(newEntries.begin(), newEntries.end());
+    entries = move(newEntries);
+    pending.clear();
+    staleIds.clear();
+    currentKey.clear();
+    for (const Entry &e : entries)
+      currentKey[e.productId] = e.key;
+  }
+
+  void upsert(const string &productId, const Key &key) {
+    auto it = currentKey.find(productId);
+    if (it != currentKey.end()) {
+      if (!(it->second < key) && !(key < it->second))
+        return; // Key unchanged - nothing to reorder
+      remove(productId);
+    }
+    currentKey[productId] = key;
+    pending.push_back(Entry{key, productId});
+  }
+
+  void remove(const string &productId) {
+    auto it = currentKey.find(productId);
+    if (it == currentKey.end())
+      return;
+
+    // Drop it from the pending buffer if it never reached the sorted vector
+    for (auto p = pending.begin(); p != pending.end(); ++p) {
+      if (p->productId == productId) {
+        pending.erase(p);
+        currentKey.erase(it);
+        return;
+      }
+    }
+    staleIds.insert(productId);
+    currentKey.erase(it);
+  }
+
+  // ============================================
+  // QUERIES
+  // ============================================
+  size_t size() const { return currentKey.size(); }
+
+  // One page of product IDs after the cursor; `next` is set to the cursor
+  // for the following page (atStart stays true when nothing was returned)
+  vector<string> page(const Cursor &after, size_t limit, bool descending,
+                      Cursor &next) const {
+    merge();
+
+    vector<string> ids;
+    size_t pos = startPosition(after, descending);
+    for (; pos < entries.size() && ids.size() < limit; pos++) {
+      const Entry &e =
+          descending ? entries[entries.size() - 1 - pos] : entries[pos];
+      ids.push_back(e.productId);
+      next.key = e.key;
+      next.productId = e.productId;
+      next.atStart = false;
+    }
+    return ids;
+  }
+
+  // Ascending page of product IDs with minKey <= key <= maxKey
+  vector<string> rangePage(const Key &minKey, const Key &maxKey,
+                           const Cursor &after, size_t limit,
+                           Cursor &next) const {
+    merge();
+
+    size_t pos;
+    if (after.atStart) {
+      auto byKey = [](const Entry &e, const Key &k) { return e.key < k; };
+      pos = lower_bound(entries.begin(), entries.end(), minKey, byKey) -
+            entries.begin();
+    } else {
+      pos = startPosition(after, false);
+    }
+
+    vector<string> ids;
+    for (; pos < entries.size() && ids.size() < limit; pos++) {
+      const Entry &e = entries[pos];
+      if (maxKey < e.key)
+        break;
+      ids.push_back(e.productId);
+      next.key = e.key;
+      next.productId = e.productId;
+      next.atStart = false;
+    }
+    return ids;
+  }
+};
+
+#endif
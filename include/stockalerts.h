@@ -0,0 +1,93 @@
+#ifndef STOCKALERTS_H
+#define STOCKALERTS_H
+
+#include "product.h"
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// STOCK ALERT TYPES
+// ============================================
+enum class StockAlertType { LOW_STOCK, OUT_OF_STOCK, BACK_IN_STOCK };
+
+struct StockAlert {
+  uint64_t sequence = 0;
+  time_t timestamp = 0;
+  string productId;
+  string productName;
+  StockAlertType type = StockAlertType::LOW_STOCK;
+  int previousQuantity = 0;
+  int quantity = 0;
+  int threshold = 0;
+};
+
+// ============================================
+// STOCK ALERT MONITOR CLASS
+// ============================================
+// Watches stock levels as they change instead of scanning the catalog.
+// Each product's last level band (normal / low / out) is remembered, so
+// a mutation costs one hash lookup and raises an alert only when the
+// band changes - not again for every sale while it stays low.
+//
+// Alerts go to a bounded in-process queue that any number of
+// subscribers poll with their own cursor, and to data/alerts.log.
+
+class StockAlertMonitor {
+private:
+  enum class Band { NORMAL, LOW, OUT };
+
+  static const string ALERT_LOG_FILE;
+  static constexpr size_t MAX_RETAINED = 256;
+
+  int threshold;
+  unordered_map<string, Band> bandByProduct;
+
+  mutable mutex queueMutex;
+  deque<StockAlert> recent; // Oldest first, at most MAX_RETAINED
+  uint64_t nextSequence;
+  vector<uint64_t> subscriberCursors; // Next sequence each one will read
+
+  Band bandOf(int quantity) const;
+  void publish(StockAlert alert);
+  void appendToLog(const StockAlert &alert) const;
+
+public:
+  // ============================================
+  // CONSTRUCTORS
+  // ============================================
+  explicit StockAlertMonitor(int threshold = 10);
+
+  // ============================================
+  // MONITORING
+  // ============================================
+  // Record current levels without raising alerts (start-up, reload)
+  void seed(const vector<Product> &products);
+  void setThreshold(int newThreshold, const vector<Product> &products);
+
+  // Called on every stock change; raises an alert on a band crossing
+  void observe(const Product &product, int previousQuantity);
+  void forget(const string &productId);
+
+  // ============================================
+  // SUBSCRIBERS
+  // ============================================
+  size_t subscribe(); // Starts with the alerts raised from now on
+  vector<StockAlert> poll(size_t subscriber); // Unread alerts, oldest first
+  size_t pendingCount(size_t subscriber) const;
+  vector<StockAlert> getRecent(size_t limit) const; // Newest first
+
+  // ============================================
+  // GETTERS
+  // ============================================
+  int getThreshold() const { return threshold; }
+  static string typeToString(StockAlertType type);
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef STOCKHOLDS_H
+#define STOCKHOLDS_H
+
+#include "inventory.h"
+#include "timerwheel.h"
+#include <ctime>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// STOCK HOLD STRUCT
+// ============================================
+struct StockHold {
+  uint64_t id;
+  int ownerId; // Customer whose cart holds the stock
+  StockReservation reservation;
+  time_t expiresAt;
+};
+
+// ============================================
+// STOCK HOLD MANAGER CLASS
+// ============================================
+// Soft reservations for items sitting in carts. A hold is an inventory
+// reservation with a deadline; deadlines are tracked in a timer wheel so
+// expiring holds costs O(1) per tick regardless of how many carts are
+// open. Expired holds hand their units back to available stock.
+
+class StockHoldManager {
+private:
+  InventoryEngine &inventory;
+  TimerWheel wheel;
+  unordered_map<uint64_t, StockHold> holds;
+  unordered_map<int, vector<uint64_t>> holdsByOwner;
+  uint64_t nextHoldId;
+  uint64_t expiredCount;
+
+  void forget(uint64_t holdId);
+
+public:
+  // ============================================
+  // CONSTRUCTORS
+  // ============================================
+  explicit StockHoldManager(InventoryEngine &inventory);
+
+  // ============================================
+  // HOLDS
+  // ============================================
+  // Reserve `quantity` units until now + ttlSeconds; false if the stock
+  // is not available
+  bool placeHold(int ownerId, const string &productId, int quantity,
+                 int ttlSeconds, time_t now);
+
+  // Hand over an owner's live holds (e.g. to commit at checkout); they
+  // stop being tracked here
+  vector<StockReservation> takeHolds(int ownerId);
+
+  // Release every hold an owner has (cart cleared, logout)
+  void releaseHolds(int ownerId);
+
+  // Release holds whose deadline has passed; returns how many expired
+  size_t expire(time_t now);
+
+  // ============================================
+  // GETTERS
+  // ============================================
+  int getHeldQuantity(int ownerId, const string &productId) const;
+  time_t getEarliestExpiry(int ownerId) const; // 0 if no holds
+  size_t getActiveCount() const { return holds.size(); }
+  uint64_t getExpiredCount() const { return expiredCount; }
+};
+
+#endif
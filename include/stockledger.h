@@ -0,0 +1,108 @@
+#ifndef STOCKLEDGER_H
+#define STOCKLEDGER_H
+
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// STOCK EVENT TYPES
+// ============================================
+enum class StockEventType { SALE, RESTOCK, ADJUSTMENT, CANCELLATION };
+
+// One stock movement. `balance` is the product's stock after the event.
+struct StockEvent {
+  uint64_t sequence = 0;
+  time_t timestamp = 0;
+  string productId;
+  StockEventType type = StockEventType::ADJUSTMENT;
+  int delta = 0;
+  int balance = 0;
+  string reference; // Order ID, "admin", ...
+};
+
+// ============================================
+// STOCK LEDGER CLASS
+// ============================================
+// Append-only log of stock movements, one JSON object per line in
+// data/stock_ledger.jsonl. Current stock is the replay of that log.
+//
+// Every SNAPSHOT_INTERVAL entries the derived levels are written to
+// data/stock_snapshot.json together with the log length they cover, so
+// start-up only replays the tail of the log. The snapshot holds one
+// balance per product, so its cost does not grow with the history.
+//
+// The byte offset of every entry is appended, with its product ID, to
+// data/stock_ledger.idx as the entry is written ("<offset> <product>"
+// per line). History queries seek straight to a product's entries
+// instead of scanning the log. Entries the index is missing (a crash
+// between the two appends) are added back at the next open.
+
+class StockLedger {
+private:
+  static const string LEDGER_FILE;
+  static const string SNAPSHOT_FILE;
+  static const string INDEX_FILE;
+  static constexpr size_t SNAPSHOT_INTERVAL = 100;
+
+  ofstream log;
+  ofstream indexLog;
+  uint64_t logSize;     // Bytes in the ledger file
+  uint64_t indexedUpTo; // Entries starting before this are in the index
+  uint64_t nextSequence;
+  size_t entriesSinceSnapshot;
+
+  unordered_map<string, int> levels;
+  unordered_map<string, vector<uint64_t>> offsetsByProduct;
+
+  bool loadSnapshot(uint64_t &coveredBytes);
+  void loadIndex(uint64_t ledgerBytes);
+  void replay(uint64_t fromOffset, uint64_t coveredBytes);
+  void apply(const StockEvent &event, uint64_t offset);
+  void writeSnapshot();
+
+public:
+  // ============================================
+  // CONSTRUCTORS
+  // ============================================
+  StockLedger();
+
+  StockLedger(const StockLedger &) = delete;
+  StockLedger &operator=(const StockLedger &) = delete;
+
+  // ============================================
+  // LOG
+  // ============================================
+  // Load the last snapshot and the offset index, then replay the entries
+  // written after them
+  void open();
+
+  // Append one movement and return the product's new stock level
+  int record(const string &productId, StockEventType type, int delta,
+             const string &reference);
+
+  // ============================================
+  // QUERIES
+  // ============================================
+  bool hasProduct(const string &productId) const;
+  int getLevel(const string &productId) const;
+
+  // Most recent entries for one product, newest first
+  vector<StockEvent> history(const string &productId, size_t limit) const;
+
+  uint64_t getEntryCount() const { return nextSequence - 1; }
+  size_t getEntriesSinceSnapshot() const { return entriesSinceSnapshot; }
+
+  // ============================================
+  // EVENT TYPES
+  // ============================================
+  static string typeToString(StockEventType type);
+  static StockEventType stringToType(const string &typeStr);
+};
+
+#endif
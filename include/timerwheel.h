@@ -0,0 +1,70 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// TIMER WHEEL CLASS
+// ============================================
+// Hierarchical timing wheel with one-second ticks. Four levels of 64
+// slots cover 64 s, ~68 min, ~3 days and ~6 months. A timer sits on the
+// lowest level whose block still contains its expiry; when a lower level
+// wraps, the matching slot of the level above is cascaded down. Adding,
+// cancelling and each tick are O(1) (cascades amortise to O(1) per
+// timer), no matter how many timers are pending. Expiries further out
+// than one full rotation of the top level (~194 days) are capped to it.
+// Call advanceTo() with the current time before scheduling.
+
+class TimerWheel {
+private:
+  static constexpr int LEVELS = 4;
+  static constexpr int SLOT_BITS = 6;
+  static constexpr int SLOTS = 1 << SLOT_BITS;
+
+  struct Timer {
+    uint64_t id;
+    int64_t expiry; // Tick (epoch second) at which it fires
+  };
+
+  struct Location {
+    int level;
+    int slot;
+    list<Timer>::iterator it;
+  };
+
+  vector<list<Timer>> slots; // LEVELS * SLOTS buckets
+  unordered_map<uint64_t, Location> locations;
+  int64_t now;
+
+  list<Timer> &bucket(int level, int slot);
+  void place(const Timer &timer);
+  void cascade(int level);
+
+public:
+  // ============================================
+  // CONSTRUCTORS
+  // ============================================
+  TimerWheel();
+
+  // ============================================
+  // TIMERS
+  // ============================================
+  void schedule(uint64_t id, int64_t expiry);
+  bool cancel(uint64_t id);
+
+  // Move the clock to `time`, appending the IDs of expired timers
+  void advanceTo(int64_t time, vector<uint64_t> &expired);
+
+  // ============================================
+  // GETTERS
+  // ============================================
+  size_t size() const { return locations.size(); }
+  int64_t getNow() const { return now; }
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -42,6 +43,16 @@ public:
 
   // Get menu choice
   static int getMenuChoice(const string &prompt, int minOption, int maxOption);
+
+  // TIME
+  // Seconds since the Unix epoch
+  static int64_t currentEpoch();
+
+  // Local "YYYY-MM-DD HH:MM:SS"; thread-safe, reuses the last second's text
+  static string formatTimestamp(int64_t epoch);
+
+  // Parse "YYYY-MM-DD[ HH:MM[:SS]]" as local time; -1 if malformed
+  static int64_t parseTimestamp(const string &text);
 };
 
 #endif
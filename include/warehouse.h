@@ -0,0 +1,114 @@
+#ifndef WAREHOUSE_H
+#define WAREHOUSE_H
+
+#include "product.h"
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// WAREHOUSE STRUCTS
+// ============================================
+struct Warehouse {
+  string id;     // e.g. "MAIN"
+  string name;   // e.g. "Main Warehouse"
+  string region; // Matched against customer addresses
+};
+
+// productId -> warehouseId -> units (the on-disk form)
+using WarehouseStockMap = map<string, map<string, int>>;
+
+struct AllocationLine {
+  string productId;
+  size_t location; // Index into the warehouse list
+  int quantity;
+};
+
+// Where an order's units ship from
+struct Allocation {
+  vector<AllocationLine> lines;
+  vector<size_t> locations; // Distinct locations, in shipping order
+
+  size_t shipmentCount() const { return locations.size(); }
+};
+
+// ============================================
+// WAREHOUSE STOCK CLASS
+// ============================================
+// Per-location stock for every product. Counts are one flat array with a
+// row per product and a column per location, so a product's locations
+// are contiguous; each row's total is kept next to it and updated with
+// every cell change, so the aggregate is always a single read.
+//
+// The totals mirror Product::quantity (the stock ledger's level); the
+// application keeps the two in step.
+
+class WarehouseStock {
+private:
+  vector<Warehouse> warehouses;
+
+  unordered_map<string, size_t> rowByProduct;
+  vector<string> productByRow;
+  vector<int> cells;  // row * locationCount + location
+  vector<int> totals; // Sum of each row
+  vector<size_t> freeRows;
+
+  size_t rowOf(const string &productId) const; // Throws if unknown
+  size_t ensureRow(const string &productId);
+  int &cell(size_t row, size_t location);
+  int cell(size_t row, size_t location) const;
+
+public:
+  // ============================================
+  // CONSTRUCTORS
+  // ============================================
+  WarehouseStock(); // Starts with a single main warehouse
+
+  // ============================================
+  // LOADING
+  // ============================================
+  void load(const vector<Warehouse> &newWarehouses,
+            const WarehouseStockMap &stock);
+  WarehouseStockMap toMap() const;
+
+  // Make a product's total match `quantity` by topping up or drawing
+  // down locations in list order; returns true if anything changed
+  bool reconcile(const string &productId, int quantity);
+
+  // ============================================
+  // LOCATIONS
+  // ============================================
+  size_t addWarehouse(const Warehouse &warehouse);
+  const vector<Warehouse> &getWarehouses() const { return warehouses; }
+  size_t getLocationCount() const { return warehouses.size(); }
+  int findWarehouse(const string &warehouseId) const; // -1 if unknown
+
+  // Locations ordered nearest first: region named in the address, then
+  // the rest in list order
+  vector<size_t> locationsByDistance(const string &address) const;
+
+  // ============================================
+  // STOCK
+  // ============================================
+  int getTotal(const string &productId) const;
+  int getAt(const string &productId, size_t location) const;
+  void add(const string &productId, size_t location, int delta);
+  void removeProduct(const string &productId);
+
+  // ============================================
+  // ALLOCATION
+  // ============================================
+  // Pick locations for the lines with as few shipments as possible: one
+  // location if any can cover the whole order, else greedily the one
+  // covering the most outstanding units (nearest wins ties). Throws
+  // InsufficientStockException if the locations cannot cover the lines.
+  Allocation allocate(const vector<pair<string, int>> &lines,
+                      const string &address) const;
+  void ship(const Allocation &allocation);
+};
+
+#endif
@@ -1,11 +1,23 @@
 #include "../include/application.h"
 #include "../include/exceptions.h"
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
 
 // ============================================
 // CONSTRUCTOR
 // ============================================
 
-Application::Application() : currentUser(nullptr), running(true) {
+Application::Application()
+    : currentUser(nullptr), running(true), stockHolds(inventory),
+      alertSubscriber(0), catalogVersion(0) {
+  alertSubscriber = stockAlerts.subscribe();
   FileManager::ensureDataDirectory();
   loadData();
 }
@@ -13,11 +25,34 @@ Application::Application() : currentUser(nullptr), running(true) {
 void Application::loadData() {
   try {
     products = FileManager::loadProducts();
+    reindexProducts(0);
     users = FileManager::loadUsers();
     orders = FileManager::loadOrders();
+    settings = FileManager::loadSettings();
+    CartStore::ensureDirectory();
+    stockLedger.open();
+    reconcileStockLedger();
+    warehouseStock.load(FileManager::loadWarehouses(),
+                        FileManager::loadWarehouseStock());
+    reconcileWarehouseStock();
+    promotions.compile(FileManager::loadPromotions());
   } catch (const exception &e) {
     cout << Utils::colorText("Warning: " + string(e.what()), "yellow") << endl;
   }
+
+  orderIndex.rebuild(orders);
+  loadSalesRollups();
+  loadRecommendations();
+  warmBestSellers();
+  customerReach.build(orders, productLookup());
+  loadCustomerStats();
+  unitsSold.clear();
+  for (const Order &order : orders) {
+    for (const OrderItem &item : order.getItems()) {
+      unitsSold[item.productId] += item.quantity;
+    }
+  }
+  rebuildIndexes();
 }
 
 // ============================================
@@ -26,6 +61,9 @@ void Application::loadData() {
 
 void Application::run() {
   while (running) {
+    // Hand expired cart holds back to available stock
+    stockHolds.expire(time(nullptr));
+
     Utils::clearScreen();
     Utils::showMainHeader("🛒 MerxQ Shop System 🛒");
 
@@ -100,10 +138,12 @@ void Application::showCustomerMenu() {
   cout << Utils::colorText("6.", "green", "", "bold") << " Order History"
        << endl;
   cout << Utils::colorText("7.", "green", "", "bold") << " My Profile" << endl;
+  cout << Utils::colorText("8.", "green", "", "bold") << " Filter Products"
+       << endl;
   cout << Utils::colorText("0.", "red", "", "bold") << " Logout" << endl
        << endl;
 
-  int choice = Utils::getIntInput("Choose option: ", 0, 7);
+  int choice = Utils::getIntInput("Choose option: ", 0, 8);
 
   switch (choice) {
   case 1:
@@ -127,6 +167,9 @@ void Application::showCustomerMenu() {
   case 7:
     viewProfile();
     break;
+  case 8:
+    filterProducts();
+    break;
   case 0:
     logout();
     break;
@@ -139,6 +182,15 @@ void Application::showAdminMenu() {
        << endl;
 
   cout << Utils::colorText("ADMIN PANEL", "yellow", "", "bold") << endl << endl;
+
+  size_t newAlerts = stockAlerts.pendingCount(alertSubscriber);
+  if (newAlerts > 0) {
+    cout << Utils::colorText("🔔 " + to_string(newAlerts) +
+                                 " new stock alert(s) - see option 11",
+                             "red", "", "bold")
+         << endl
+         << endl;
+  }
   cout << Utils::colorText("1.", "yellow", "", "bold") << " View Inventory"
        << endl;
   cout << Utils::colorText("2.", "yellow", "", "bold") << " Add Product"
@@ -153,10 +205,26 @@ void Application::showAdminMenu() {
        << endl;
   cout << Utils::colorText("7.", "yellow", "", "bold") << " View All Users"
        << endl;
+  cout << Utils::colorText("8.", "yellow", "", "bold") << " System Statistics"
+       << endl;
+  cout << Utils::colorText("9.", "yellow", "", "bold") << " Store Settings"
+       << endl;
+  cout << Utils::colorText("10.", "yellow", "", "bold") << " Stock History"
+       << endl;
+  cout << Utils::colorText("11.", "yellow", "", "bold") << " Stock Alerts"
+       << endl;
+  cout << Utils::colorText("12.", "yellow", "", "bold") << " Warehouses"
+       << endl;
+  cout << Utils::colorText("13.", "yellow", "", "bold") << " Promotions"
+       << endl;
+  cout << Utils::colorText("14.", "yellow", "", "bold") << " Sales Reports"
+       << endl;
+  cout << Utils::colorText("15.", "yellow", "", "bold") << " Order Analytics"
+       << endl;
   cout << Utils::colorText("0.", "red", "", "bold") << " Logout" << endl
        << endl;
 
-  int choice = Utils::getIntInput("Choose option: ", 0, 7);
+  int choice = Utils::getIntInput("Choose option: ", 0, 15);
 
   switch (choice) {
   case 1:
@@ -180,6 +248,30 @@ void Application::showAdminMenu() {
   case 7:
     viewAllUsers();
     break;
+  case 8:
+    viewSystemStats();
+    break;
+  case 9:
+    storeSettings();
+    break;
+  case 10:
+    viewStockHistory();
+    break;
+  case 11:
+    viewStockAlerts();
+    break;
+  case 12:
+    manageWarehouses();
+    break;
+  case 13:
+    managePromotions();
+    break;
+  case 14:
+    viewSalesReports();
+    break;
+  case 15:
+    viewOrderAnalytics();
+    break;
   case 0:
     logout();
     break;
@@ -203,6 +295,9 @@ void Application::login() {
       currentUser = user;
       cout << Utils::colorText("✓ Login successful!", "green", "", "bold")
            << endl;
+      if (currentUser->getRole() == "customer") {
+        restoreCart();
+      }
       Utils::pauseScreen();
     } else {
       throw AuthenticationException("Incorrect password");
@@ -256,12 +351,102 @@ void Application::registerCustomer() {
 }
 
 void Application::logout() {
+  // The saved cart stays on disk for the next login
+  stockHolds.releaseHolds(currentUser->getId());
   currentUser = nullptr;
+  cartFeed.unsubscribeAll(&currentCart);
   currentCart.clear();
   cout << Utils::colorText("✓ Logged out successfully!", "green") << endl;
   Utils::pauseScreen();
 }
 
+// Bring back the cart saved at the customer's last change. Lines for
+// deleted products are dropped; holds are placed again where stock
+// allows.
+void Application::restoreCart() {
+  int customerId = currentUser->getId();
+  try {
+    Cart saved = CartStore::load(customerId);
+    cartFeed.unsubscribeAll(&currentCart);
+    currentCart.clear();
+    for (const CartItem &item : saved.getItems()) {
+      currentCart.restoreItem(item);
+    }
+
+    // Saved carts miss changes made while they sat on disk, so every line
+    // is re-read once now; from here on only changed products are
+    currentCart.markAllStale();
+    refreshCart();
+    for (const CartItem &item : currentCart.getItems()) {
+      cartFeed.subscribe(item.productId, &currentCart);
+      if (settings.cartHoldsEnabled) {
+        stockHolds.placeHold(customerId, item.productId, item.quantity,
+                             settings.cartHoldTtlSeconds, time(nullptr));
+      }
+    }
+    if (!currentCart.isEmpty()) {
+      cout << Utils::colorText("Welcome back - your cart has " +
+                                   to_string(currentCart.getTotalQuantity()) +
+                                   " item(s) waiting.",
+                               "yellow")
+           << endl;
+    }
+  } catch (const exception &e) {
+    cout << Utils::colorText("Warning: " + string(e.what()), "yellow") << endl;
+  }
+}
+
+// Write-through: the customer's cart file is rewritten on every change
+void Application::persistCart() {
+  try {
+    CartStore::save(currentUser->getId(), currentCart);
+  } catch (const exception &e) {
+    cout << Utils::colorText("Warning: cart not saved - " + string(e.what()),
+                             "yellow")
+         << endl;
+  }
+}
+
+// Brings stale cart lines up to date and tells the customer what changed
+void Application::refreshCart() {
+  if (!currentCart.isStale())
+    return;
+
+  bool linesChanged = false;
+  for (const CartChange &change : currentCart.refresh(productLookup())) {
+    const Product *product = findProductById(change.productId);
+    string name = product != nullptr ? product->getName() : change.productId;
+    switch (change.type) {
+    case CartChangeType::REMOVED:
+      cartFeed.unsubscribe(change.productId, &currentCart);
+      cout << Utils::colorText("✗ " + name +
+                                   " is no longer sold and was removed "
+                                   "from your cart.",
+                               "red")
+           << endl;
+      linesChanged = true;
+      break;
+    case CartChangeType::PRICE_CHANGED:
+      cout << Utils::colorText("Price of " + name + " changed: " +
+                                   change.oldPrice.format() + " → " +
+                                   change.newPrice.format(),
+                               "yellow")
+           << endl;
+      linesChanged = true;
+      break;
+    case CartChangeType::LOW_STOCK:
+      cout << Utils::colorText("Only " + to_string(change.available) + " of " +
+                                   name + " left in stock.",
+                               "yellow")
+           << endl;
+      break;
+    }
+  }
+  if (linesChanged) {
+    persistCart();
+  }
+}
+
 
 
 
@@ -276,6 +461,15 @@ void Application::displayProductList() const {
     return;
   }
 
+  vector<const Product *> rows;
+  for (const Product &p : products) {
+    rows.push_back(&p);
+  }
+  displayProductTable(rows);
+}
+
+void Application::displayProductTable(
+    const vector<const Product *> &rows) const {
   cout << endl;
   cout << Utils::colorText("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
                            "━━━━━━━━━━━━━━",
@@ -290,8 +484,8 @@ void Application::displayProductList() const {
                            "yellow")
        << endl;
 
-  for (const Product &p : products) {
-    p.displayShort();
+  for (const Product *p : rows) {
+    p->displayShort(inventory.getReserved(p->getId()));
   }
   cout << Utils::colorText("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
                            "━━━━━━━━━━━━━━",
@@ -303,10 +497,101 @@ void Application::browseProducts() {
   Utils::clearScreen();
   Utils::showSubHeader("📦 Product Catalog");
 
-  products = FileManager::loadProducts(); // Refresh
-  displayProductList();
+  if (products.empty()) {
+    cout << Utils::colorText("No products available.", "yellow") << endl;
+    Utils::pauseScreen();
+    return;
+  }
 
-  Utils::pauseScreen();
+  displayBestSellers(SalesWindow::LAST_WEEK, 3);
+  cout << Utils::colorText("Sort by:", "yellow") << endl;
+  cout << "1. Catalog order" << endl;
+  cout << "2. Price: Low to High" << endl;
+  cout << "3. Price: High to Low" << endl;
+  cout << "4. Name: A to Z" << endl;
+  cout << "5. Price range" << endl;
+
+  int sortChoice = Utils::getIntInput("Choose: ", 1, 5);
+
+  Money minPrice, maxPrice;
+  if (sortChoice == 5) {
+    double low = Utils::getDoubleInput("Min Price: $", 0.0, 999999.99);
+    double high = Utils::getDoubleInput("Max Price: $", low, 999999.99);
+    minPrice = Money::fromDouble(low);
+    maxPrice = Money::fromDouble(high);
+  }
+
+  // Keyset pagination: cursors[i] is where page i starts, so going back
+  // re-reads a page without re-sorting or skipping from the start
+  const size_t PAGE_SIZE = 10;
+  vector<SortedIndex<Money>::Cursor> priceCursors(1);
+  vector<SortedIndex<string>::Cursor> nameCursors(1);
+  size_t pageNumber = 0;
+
+  while (true) {
+    vector<string> ids;
+    vector<const Product *> rows;
+
+    if (sortChoice == 1) {
+      // Catalog order is position order - no lookups needed
+      for (size_t i = pageNumber * PAGE_SIZE;
+           i < products.size() && rows.size() < PAGE_SIZE; i++) {
+        ids.push_back(products[i].getId());
+        rows.push_back(&products[i]);
+      }
+    } else if (sortChoice == 4) {
+      SortedIndex<string>::Cursor next;
+      ids = nameIndex.page(nameCursors[pageNumber], PAGE_SIZE, false, next);
+      if (nameCursors.size() == pageNumber + 1)
+        nameCursors.push_back(next);
+    } else {
+      SortedIndex<Money>::Cursor next;
+      if (sortChoice == 5) {
+        ids = priceIndex.rangePage(minPrice, maxPrice,
+                                   priceCursors[pageNumber], PAGE_SIZE, next);
+      } else {
+        ids = priceIndex.page(priceCursors[pageNumber], PAGE_SIZE,
+                              sortChoice == 3, next);
+      }
+      if (priceCursors.size() == pageNumber + 1)
+        priceCursors.push_back(next);
+    }
+
+    Utils::clearScreen();
+    Utils::showSubHeader("📦 Product Catalog");
+
+    if (ids.empty()) {
+      cout << Utils::colorText(pageNumber == 0 ? "No products found."
+                                               : "No more products.",
+                               "yellow")
+           << endl;
+    } else {
+      // Index pages hold IDs; each resolves in O(1) through productSlots
+      if (sortChoice != 1) {
+        for (const string &id : ids) {
+          const Product *p = findProductById(id);
+          if (p != nullptr)
+            rows.push_back(p);
+        }
+      }
+      cout << Utils::colorText("Page " + to_string(pageNumber + 1), "yellow")
+           << endl;
+      displayProductTable(rows);
+    }
+
+    bool hasNext = ids.size() == PAGE_SIZE;
+    string nav = Utils::getStringInput(
+        string(hasNext ? "[n]ext, " : "") +
+        (pageNumber > 0 ? "[p]revious, " : "") + "[b]ack: ");
+
+    if (nav == "n" && hasNext) {
+      pageNumber++;
+    } else if (nav == "p" && pageNumber > 0) {
+      pageNumber--;
+    } else if (nav == "b") {
+      break;
+    }
+  }
 }
 
 void Application::searchProducts() {
@@ -314,33 +599,63 @@ void Application::searchProducts() {
   Utils::showSubHeader("🔍 Search Products");
 
   string query = Utils::getStringInput("Search term: ");
-
-  // Convert query to lowercase for case-insensitive search
-  string queryLower = query;
-  for (char &c : queryLower)
-    c = tolower(c);
+  string category =
+      Utils::getStringInput("Category filter (blank for any): ");
+
+  FacetQuery filters;
+  if (!category.empty()) {
+    // Match the category name case-insensitively against the index
+    for (const string &c : facetIndex.getCategories()) {
+      if (nameKey(c) == nameKey(category))
+        filters.categories.push_back(c);
+    }
+    if (filters.categories.empty())
+      filters.categories.push_back(category);
+  }
 
   cout << endl;
   cout << Utils::colorText("Search results for: ", "white")
        << Utils::colorText(query, "yellow", "", "bold") << endl;
 
+  vector<Completion> suggestions = autocomplete.complete(
+      SearchCache::normalizeQuery(query), 5);
+  if (!suggestions.empty()) {
+    cout << Utils::colorText("Suggestions: ", "white");
+    for (size_t i = 0; i < suggestions.size(); i++) {
+      cout << (i > 0 ? ", " : "")
+           << Utils::colorText(suggestions[i].text, "yellow");
+    }
+    cout << endl;
+  }
+
+  string cacheKey = SearchCache::makeKey(query, filters);
+  vector<string> resultIds;
+
+  if (!searchCache.lookup(cacheKey, catalogVersion, resultIds)) {
+    string queryLower = SearchCache::normalizeQuery(query);
+
+    // Restrict the scan to products passing the filters
+    vector<string> candidates = facetIndex.query(filters).productIds;
+    for (const string &id : candidates) {
+      const Product *p = findProductById(id);
+      if (p == nullptr)
+        continue;
+
+      // Convert product fields to lowercase for comparison
+      if (nameKey(p->getName()).find(queryLower) != string::npos ||
+          nameKey(p->getCategory()).find(queryLower) != string::npos ||
+          nameKey(p->getDescription()).find(queryLower) != string::npos) {
+        resultIds.push_back(id);
+      }
+    }
+    searchCache.store(cacheKey, catalogVersion, resultIds);
+  }
+
   bool found = false;
-  for (const Product &p : products) {
-    // Convert product fields to lowercase for comparison
-    string nameLower = p.getName();
-    string catLower = p.getCategory();
-    string descLower = p.getDescription();
-    for (char &c : nameLower)
-      c = tolower(c);
-    for (char &c : catLower)
-      c = tolower(c);
-    for (char &c : descLower)
-      c = tolower(c);
-
-    if (nameLower.find(queryLower) != string::npos ||
-        catLower.find(queryLower) != string::npos ||
-        descLower.find(queryLower) != string::npos) {
-      p.displayShort();
+  for (const string &id : resultIds) {
+    const Product *p = findProductById(id);
+    if (p != nullptr) {
+      p->displayShort();
       found = true;
     }
   }
@@ -354,11 +669,97 @@ void Application::searchProducts() {
   Utils::pauseScreen();
 }
 
+void Application::filterProducts() {
+  Utils::clearScreen();
+  Utils::showSubHeader("🧭 Filter Products");
+
+  // Show the facet values with their current counts
+  FacetResult overview = facetIndex.query(FacetQuery());
+  vector<string> categories = facetIndex.getCategories();
+
+  cout << Utils::colorText("Categories:", "yellow", "", "bold") << endl;
+  for (size_t i = 0; i < categories.size(); i++) {
+    cout << "  " << (i + 1) << ". " << categories[i] << " ("
+         << overview.categoryCounts[categories[i]] << ")" << endl;
+  }
+  cout << Utils::colorText("Price:", "yellow", "", "bold") << endl;
+  for (int b = 0; b < FacetIndex::priceBandCount(); b++) {
+    cout << "  " << (b + 1) << ". " << FacetIndex::priceBandLabel(b) << " ("
+         << overview.priceBandCounts[b] << ")" << endl;
+  }
+  cout << Utils::colorText("Stock:", "yellow", "", "bold") << endl;
+  for (int s = 0; s < 3; s++) {
+    cout << "  " << (s + 1) << ". "
+         << FacetIndex::stockStateLabel(static_cast<StockState>(s)) << " ("
+         << overview.stockStateCounts[s] << ")" << endl;
+  }
+  cout << endl;
+
+  // Read a comma separated list of option numbers (blank means any)
+  auto readChoices = [](const string &prompt, int maxOption) {
+    vector<int> choices;
+    stringstream ss(Utils::getStringInput(prompt));
+    string token;
+    while (getline(ss, token, ',')) {
+      try {
+        int n = stoi(token);
+        if (n >= 1 && n <= maxOption)
+          choices.push_back(n - 1);
+      } catch (...) {
+      }
+    }
+    return choices;
+  };
+
+  FacetQuery query;
+  for (int c : readChoices("Categories (e.g. 1,3 - blank for any): ",
+                           categories.size()))
+    query.categories.push_back(categories[c]);
+  query.priceBands = readChoices("Price bands (blank for any): ",
+                                 FacetIndex::priceBandCount());
+  for (int s : readChoices("Stock states (blank for any): ", 3))
+    query.stockStates.push_back(static_cast<StockState>(s));
+
+  FacetResult result = facetIndex.query(query);
+
+  vector<const Product *> rows;
+  for (const string &id : result.productIds) {
+    const Product *p = findProductById(id);
+    if (p != nullptr)
+      rows.push_back(p);
+  }
+
+  cout << endl
+       << Utils::colorText(to_string(rows.size()) + " matching products",
+                           "yellow", "", "bold")
+       << endl;
+  if (!rows.empty()) {
+    displayProductTable(rows);
+  }
+
+  cout << Utils::colorText("Refine by:", "yellow") << endl;
+  for (const auto &entry : result.categoryCounts) {
+    if (entry.second > 0)
+      cout << "  " << entry.first << " (" << entry.second << ")" << endl;
+  }
+  for (int b = 0; b < FacetIndex::priceBandCount(); b++) {
+    if (result.priceBandCounts[b] > 0)
+      cout << "  " << FacetIndex::priceBandLabel(b) << " ("
+           << result.priceBandCounts[b] << ")" << endl;
+  }
+  for (int s = 0; s < 3; s++) {
+    if (result.stockStateCounts[s] > 0)
+      cout << "  " << FacetIndex::stockStateLabel(static_cast<StockState>(s))
+           << " (" << result.stockStateCounts[s] << ")" << endl;
+  }
+
+  Utils::pauseScreen();
+}
+
 void Application::addToCart() {
   Utils::clearScreen();
   Utils::showSubHeader("🛒 Add to Cart");
 
-  products = FileManager::loadProducts();
   displayProductList();
 
   string productId = Utils::getStringInput("Enter Product ID (or 'back'): ");
@@ -366,18 +767,36 @@ void Application::addToCart() {
     return;
 
   try {
-    Product product = FileManager::findProduct(productId);
+    const Product *found = findProductById(productId);
+    if (found == nullptr) {
+      throw ProductNotFoundException("Product not found: " + productId);
+    }
+    Product product = *found;
 
-    if (!product.isInStock()) {
+    int available = inventory.getAvailable(productId);
+    if (available <= 0) {
       cout << Utils::colorText("✗ Product is out of stock!", "red") << endl;
       Utils::pauseScreen();
       return;
     }
 
-    int quantity = Utils::getIntInput("Quantity: ", 1, product.getQuantity());
+    int quantity = Utils::getIntInput("Quantity: ", 1, available);
+
+    if (settings.cartHoldsEnabled &&
+        !stockHolds.placeHold(currentUser->getId(), productId, quantity,
+                              settings.cartHoldTtlSeconds, time(nullptr))) {
+      cout << Utils::colorText("✗ That quantity is no longer available!",
+                               "red")
+           << endl;
+      Utils::pauseScreen();
+      return;
+    }
 
     currentCart.addItem(product, quantity);
+    cartFeed.subscribe(productId, &currentCart);
+    persistCart();
     cout << Utils::colorText("✓ Added to cart!", "green", "", "bold") << endl;
+    displayRecommendations({productId});
     Utils::pauseScreen();
   } catch (const ProductNotFoundException &e) {
     cout << Utils::colorText("✗ " + string(e.what()), "red") << endl;
@@ -389,7 +808,32 @@ void Application::viewCart() {
   Utils::clearScreen();
   Utils::showSubHeader("🛒 Your Cart");
 
-  currentCart.displayCart();
+  refreshCart();
+  currentCart.displayCart(productLookup());
+  if (!currentCart.isEmpty()) {
+    displayPricing(promotions.price(currentCart, productLookup()));
+
+    vector<string> inCart;
+    for (const CartItem &item : currentCart.getItems())
+      inCart.push_back(item.productId);
+    displayRecommendations(inCart);
+  }
+
+  if (settings.cartHoldsEnabled && !currentCart.isEmpty()) {
+    time_t expiresAt = stockHolds.getEarliestExpiry(currentUser->getId());
+    if (expiresAt != 0) {
+      long minutes = (expiresAt - time(nullptr) + 59) / 60;
+      cout << Utils::colorText("Stock is held for you for another " +
+                                   to_string(minutes) + " min.",
+                               "green")
+           << endl;
+    } else {
+      cout << Utils::colorText("Your stock hold has expired - availability "
+                               "will be re-checked at checkout.",
+                               "yellow")
+           << endl;
+    }
+  }
   Utils::pauseScreen();
 }
 
@@ -397,13 +841,28 @@ void Application::checkout() {
   Utils::clearScreen();
   Utils::showSubHeader("💳 Checkout");
 
+  // Charge today's prices, not the ones from when items were added
+  refreshCart();
   if (currentCart.isEmpty()) {
     cout << Utils::colorText("Your cart is empty!", "yellow") << endl;
     Utils::pauseScreen();
     return;
   }
 
-  currentCart.displayCart();
+  currentCart.displayCart(productLookup());
+
+  PricedCart priced = promotions.price(currentCart, productLookup());
+  string coupon = PromotionEngine::normalizeCode(
+      Utils::getStringInput("Coupon code (Enter to skip): "));
+  if (!coupon.empty()) {
+    try {
+      priced = promotions.price(currentCart, productLookup(), coupon);
+    } catch (const InvalidInputException &e) {
+      cout << Utils::colorText("✗ " + string(e.what()), "red") << endl;
+      coupon.clear();
+    }
+  }
+  displayPricing(priced);
 
   cout << endl;
   string confirm = Utils::getStringInput("Confirm order? (yes/no): ");
@@ -415,25 +874,104 @@ void Application::checkout() {
   }
 
   try {
-    // Create order
-    string orderId = FileManager::generateOrderId();
-    Order order =
-        Order::createFromCart(orderId, currentUser->getId(), currentCart);
+    // Reserve stock for every line first - all or nothing, so another
+    // session can never sell the same units
+    // Units still held for this cart count towards it; anything a hold
+    // does not cover (expired or never held) is reserved now
+    map<string, int> needed;
+    for (const CartItem &item : currentCart.getItems()) {
+      needed[item.productId] += item.quantity;
+    }
 
-    // Save order
-    FileManager::addOrder(order);
+    // Flash-sale products only let a limited rate of checkouts through
+    for (const auto &entry : needed) {
+      if (!inventory.admit(entry.first)) {
+        const Product *p = findProductById(entry.first);
+        throw MerxQException("High demand for " +
+                             (p != nullptr ? p->getName() : entry.first) +
+                             " - please try again in a moment");
+      }
+    }
 
-    // Update product stock
-    for (const CartItem &item : currentCart.getItems()) {
-      Product p = FileManager::findProduct(item.product.getId());
-      p.reduceStock(item.quantity);
-      FileManager::updateProduct(p);
+    vector<StockReservation> held;
+    vector<StockReservation> surplus;
+    for (const StockReservation &r :
+         stockHolds.takeHolds(currentUser->getId())) {
+      if (needed[r.productId] >= r.quantity) {
+        needed[r.productId] -= r.quantity;
+        held.push_back(r);
+      } else {
+        surplus.push_back(r);
+      }
+    }
+    inventory.releaseAll(surplus);
+
+    vector<pair<string, int>> lines;
+    for (const auto &entry : needed) {
+      if (entry.second > 0)
+        lines.push_back({entry.first, entry.second});
+    }
+    try {
+      vector<StockReservation> extra = inventory.reserveAll(lines);
+      held.insert(held.end(), extra.begin(), extra.end());
+    } catch (...) {
+      inventory.releaseAll(held);
+      throw;
     }
 
+    map<string, int> sold;
+    for (const StockReservation &r : held) {
+      sold[r.productId] += r.quantity;
+    }
+
+    // Pick shipping locations, then create and save the order; give the
+    // stock back if either fails
+    string orderId = FileManager::generateOrderId();
+    Allocation allocation;
+    Order order;
+    try {
+      allocation = warehouseStock.allocate(
+          vector<pair<string, int>>(sold.begin(), sold.end()),
+          shippingAddress());
+      order = Order::createFromCart(orderId, currentUser->getId(),
+                                    currentCart, productLookup());
+      order.setDiscount(priced.getDiscount(), coupon);
+      FileManager::addOrder(order);
+    } catch (...) {
+      inventory.releaseAll(held);
+      throw;
+    }
+    inventory.commitAll(held);
+    orders.push_back(move(order));
+    orderIndex.add(orders.back(), orders.size() - 1);
+    salesRollup.orderPlaced(orders.back(), productLookup());
+    saveSalesRollups();
+    recommender.orderPlaced(orders.back(), orders);
+    saveRecommendations();
+    for (const OrderItem &item : orders.back().getItems()) {
+      bestSellers.record(item.productId, item.quantity,
+                         orders.back().getCreatedAt());
+    }
+    customerReach.orderPlaced(orders.back(), productLookup());
+    customerStats.orderPlaced(orders.back());
+    persistCustomerStats(currentUser->getId());
+    warehouseStock.ship(allocation);
+    saveWarehouseStock();
+
+    // One ledger entry per product sold, then persist the new on-hand
+    // quantities in one write
+    for (const auto &entry : sold) {
+      recordStockMovement(entry.first, StockEventType::SALE, -entry.second,
+                          orderId);
+      unitsSold[entry.first] += entry.second;
+    }
+    FileManager::saveProducts(products);
+    scheduleAutocompleteRebuild();
+
     // Clear cart
+    cartFeed.unsubscribeAll(&currentCart);
     currentCart.clear();
-    products = FileManager::loadProducts();
-    orders = FileManager::loadOrders();
+    persistCart();
 
     cout << endl;
     cout << Utils::colorText("╔═══════════════════════════════════════════╗",
@@ -452,6 +990,17 @@ void Application::checkout() {
                              "green")
          << endl;
 
+    string origins;
+    for (size_t loc : allocation.locations) {
+      origins += (origins.empty() ? "" : ", ") +
+                 warehouseStock.getWarehouses()[loc].name;
+    }
+    cout << "Ships from: " << Utils::colorText(origins, "yellow");
+    if (allocation.shipmentCount() > 1) {
+      cout << " (" << allocation.shipmentCount() << " shipments)";
+    }
+    cout << endl;
+
     Utils::pauseScreen();
   } catch (const exception &e) {
     cout << Utils::colorText("✗ Error: " + string(e.what()), "red") << endl;
@@ -460,36 +1009,22 @@ void Application::checkout() {
 }
 
 void Application::viewOrderHistory() {
-  Utils::clearScreen();
-  Utils::showSubHeader("📋 Order History");
-
-  vector<Order> customerOrders =
-      FileManager::getCustomerOrders(currentUser->getId());
-
-  if (customerOrders.empty()) {
+  OrderQuery query;
+  query.customerId = currentUser->getId();
+  if (orderIndex.count(query) == 0) {
+    Utils::clearScreen();
+    Utils::showSubHeader("📋 Order History");
     cout << Utils::colorText("You haven't placed any orders yet.", "yellow")
          << endl;
     Utils::pauseScreen();
     return;
   }
 
-  cout << endl;
-  for (const Order &order : customerOrders) {
-    order.displayShort();
-  }
-
-  string viewDetails = Utils::getStringInput(
-      "\nView order details? Enter Order ID (or 'back'): ");
-  if (viewDetails != "back") {
-    for (const Order &order : customerOrders) {
-      if (order.getId() == viewDetails) {
-        order.displayOrder();
-        break;
-      }
-    }
+  const Order *order = findOrder(pickOrder(query, "📋 Order History"));
+  if (order != nullptr && order->getCustomerId() == currentUser->getId()) {
+    order->displayOrder();
+    Utils::pauseScreen();
   }
-
-  Utils::pauseScreen();
 }
 
 void Application::viewProfile() {
@@ -497,6 +1032,23 @@ void Application::viewProfile() {
   Utils::showSubHeader("👤 My Profile");
 
   currentUser->displayInfo();
+  cout << "  Cart:    "
+       << Utils::colorText(to_string(currentCart.getTotalQuantity()) +
+                               " items",
+                           "yellow")
+       << endl;
+
+  const CustomerTotals &totals = customerStats.get(currentUser->getId());
+  cout << "  Orders:  " << totals.orders;
+  if (totals.cancelled > 0)
+    cout << " (" << totals.cancelled << " cancelled)";
+  cout << endl;
+  cout << "  Spent:   " << Utils::colorText(totals.getSpend().format(), "green")
+       << endl;
+  if (totals.lastOrderAt > 0) {
+    cout << "  Last order: " << Utils::formatTimestamp(totals.lastOrderAt)
+         << endl;
+  }
   Utils::pauseScreen();
 }
 
@@ -511,8 +1063,6 @@ void Application::viewInventory() {
   Utils::clearScreen();
   Utils::showSubHeader("📦 Inventory Management");
 
-  products = FileManager::loadProducts();
-
   cout << Utils::colorText("Total Products: " + to_string(products.size()),
                            "yellow")
        << endl;
@@ -528,15 +1078,25 @@ void Application::addProduct() {
   string name = Utils::getStringInput("Product Name: ");
   string category = Utils::getStringInput("Category: ");
   string description = Utils::getStringInput("Description: ");
-  double price = Utils::getDoubleInput("Price: $", 0.01, 999999.99);
+  Money price =
+      Money::fromDouble(Utils::getDoubleInput("Price: $", 0.01, 999999.99));
   int quantity = Utils::getIntInput("Stock Quantity: ", 0, 999999);
 
   try {
     string productId = FileManager::generateProductId();
     Product newProduct(productId, name, category, description, price, quantity);
 
+    if (quantity > 0) {
+      size_t location = chooseWarehouse(productId);
+      stockLedger.record(
+          productId, StockEventType::RESTOCK, quantity,
+          adminReference() + " @ " +
+              warehouseStock.getWarehouses()[location].id);
+      warehouseStock.add(productId, location, quantity);
+      saveWarehouseStock();
+    }
     FileManager::updateProduct(newProduct);
-    products = FileManager::loadProducts();
+    onProductChanged(newProduct);
 
     cout << Utils::colorText("✓ Product added successfully!", "green", "",
                              "bold")
@@ -559,7 +1119,7 @@ void Application::updateProduct() {
 
   try {
     Product product = FileManager::findProduct(productId);
-    product.displayInfo();
+    product.displayInfo(settings.lowStockThreshold);
 
     cout << endl << Utils::colorText("What to update?", "yellow") << endl;
     cout << "1. Name" << endl;
@@ -575,11 +1135,35 @@ void Application::updateProduct() {
       product.setName(Utils::getStringInput("New Name: "));
       break;
     case 2:
-      product.setPrice(Utils::getDoubleInput("New Price: $", 0.01, 999999.99));
+      product.setPrice(Money::fromDouble(
+          Utils::getDoubleInput("New Price: $", 0.01, 999999.99)));
       break;
-    case 3:
-      product.setQuantity(Utils::getIntInput("New Stock: ", 0, 999999));
+    case 3: {
+      cout << "1. Restock (add received units)" << endl;
+      cout << "2. Adjust to counted stock" << endl;
+      bool restock = Utils::getIntInput("Choose: ", 1, 2) == 1;
+      size_t location = chooseWarehouse(productId);
+      string reference = adminReference() + " @ " +
+                         warehouseStock.getWarehouses()[location].id;
+
+      if (restock) {
+        int received = Utils::getIntInput("Units received: ", 1, 999999);
+        product.setQuantity(stockLedger.record(
+            productId, StockEventType::RESTOCK, received, reference));
+        warehouseStock.add(productId, location, received);
+      } else {
+        int current = warehouseStock.getAt(productId, location);
+        int counted = Utils::getIntInput("Counted Stock: ", 0, 999999);
+        if (counted != current) {
+          product.setQuantity(stockLedger.record(
+              productId, StockEventType::ADJUSTMENT, counted - current,
+              reference));
+          warehouseStock.add(productId, location, counted - current);
+        }
+      }
+      saveWarehouseStock();
       break;
+    }
     case 4:
       product.setDescription(Utils::getStringInput("New Description: "));
       break;
@@ -589,7 +1173,7 @@ void Application::updateProduct() {
     }
 
     FileManager::updateProduct(product);
-    products = FileManager::loadProducts();
+    onProductChanged(product);
 
     cout << Utils::colorText("✓ Product updated!", "green", "", "bold") << endl;
     Utils::pauseScreen();
@@ -609,12 +1193,19 @@ void Application::deleteProduct() {
 
   try {
     Product product = FileManager::findProduct(productId);
-    product.displayInfo();
+    product.displayInfo(settings.lowStockThreshold);
 
     string confirm = Utils::getStringInput("Are you sure? (yes/no): ");
     if (confirm == "yes" || confirm == "y") {
+      int level = stockLedger.getLevel(productId);
+      if (level != 0) {
+        stockLedger.record(productId, StockEventType::ADJUSTMENT, -level,
+                           adminReference() + " (deleted)");
+      }
       FileManager::deleteProduct(productId);
-      products = FileManager::loadProducts();
+      onProductRemoved(productId);
+      warehouseStock.removeProduct(productId);
+      saveWarehouseStock();
       cout << Utils::colorText("✓ Product deleted!", "green", "", "bold")
            << endl;
     } else {
@@ -631,86 +1222,79 @@ void Application::viewAllOrders() {
   Utils::clearScreen();
   Utils::showSubHeader("📋 All Orders");
 
-  orders = FileManager::loadOrders();
-
   if (orders.empty()) {
     cout << Utils::colorText("No orders yet.", "yellow") << endl;
     Utils::pauseScreen();
     return;
   }
 
-  cout << Utils::colorText("Total Orders: " + to_string(orders.size()),
-                           "yellow")
-       << endl
-       << endl;
-
-  for (const Order &order : orders) {
-    order.displayShort();
-  }
-
-  string viewDetails = Utils::getStringInput(
-      "\nView order details? Enter Order ID (or 'back'): ");
-  if (viewDetails != "back") {
-    for (const Order &order : orders) {
-      if (order.getId() == viewDetails) {
-        order.displayOrder();
-        break;
-      }
-    }
+  OrderQuery query = promptOrderQuery();
+  const Order *order = findOrder(pickOrder(query, "📋 All Orders"));
+  if (order != nullptr) {
+    order->displayOrder();
+    Utils::pauseScreen();
   }
-
-  Utils::pauseScreen();
 }
 
 void Application::updateOrderStatus() {
   Utils::clearScreen();
   Utils::showSubHeader("📝 Update Order Status");
 
-  orders = FileManager::loadOrders();
-
-  for (const Order &order : orders) {
-    order.displayShort();
+  for (size_t i = 0; i < ORDER_STATUS_COUNT; i++) {
+    OrderStatus status = static_cast<OrderStatus>(i);
+    cout << "  " << left << setw(12) << Order::statusToString(status)
+         << orderIndex.countByStatus(status) << endl;
   }
+  cout << endl;
 
-  string orderId = Utils::getStringInput("\nEnter Order ID: ");
+  // The order that has waited longest since it was placed
+  int nextSlot = orderIndex.oldestIn(OrderStatus::PENDING);
+  cout << "1. Process next pending order"
+       << (nextSlot >= 0 ? " (" + orders[nextSlot].getId() + ")" : " (none)")
+       << endl;
+  cout << "2. Choose an order" << endl;
+  cout << "3. Batch update (ID list or filter)" << endl;
+  cout << Utils::colorText("0.", "red", "", "bold") << " Back" << endl;
 
-  cout << endl << Utils::colorText("Select new status:", "yellow") << endl;
-  cout << "1. Pending" << endl;
-  cout << "2. Confirmed" << endl;
-  cout << "3. Processing" << endl;
-  cout << "4. Shipped" << endl;
-  cout << "5. Delivered" << endl;
-  cout << "6. Cancelled" << endl;
+  int mode = Utils::getIntInput("Choose: ", 0, 3);
+  if (mode == 3) {
+    batchUpdateOrderStatus();
+    return;
+  }
+  string orderId;
+  if (mode == 1 && nextSlot >= 0) {
+    orderId = orders[nextSlot].getId();
+    orders[nextSlot].displayOrder();
+  } else if (mode == 2) {
+    orderId = pickOrder(promptOrderQuery(), "📝 Update Order Status");
+  }
+  if (orderId.empty())
+    return;
 
-  int choice = Utils::getIntInput("Choose: ", 1, 6);
+  const Order *chosen = findOrder(orderId);
+  vector<OrderStatus> allowed = Order::nextStatuses(chosen->getStatus());
+  if (allowed.empty()) {
+    cout << Utils::colorText("✗ " + chosen->getStatusString() +
+                                 " orders cannot change status.",
+                             "red")
+         << endl;
+    Utils::pauseScreen();
+    return;
+  }
 
-  OrderStatus newStatus;
-  switch (choice) {
-  case 1:
-    newStatus = OrderStatus::PENDING;
-    break;
-  case 2:
-    newStatus = OrderStatus::CONFIRMED;
-    break;
-  case 3:
-    newStatus = OrderStatus::PROCESSING;
-    break;
-  case 4:
-    newStatus = OrderStatus::SHIPPED;
-    break;
-  case 5:
-    newStatus = OrderStatus::DELIVERED;
-    break;
-  case 6:
-    newStatus = OrderStatus::CANCELLED;
-    break;
-  default:
-    newStatus = OrderStatus::PENDING;
+  cout << endl << Utils::colorText("Select new status:", "yellow") << endl;
+  for (size_t i = 0; i < allowed.size(); i++) {
+    cout << (i + 1) << ". " << Order::statusToString(allowed[i]) << endl;
   }
+  OrderStatus newStatus =
+      allowed[Utils::getIntInput("Choose: ", 1, allowed.size()) - 1];
 
   try {
-    FileManager::updateOrderStatus(orderId, newStatus);
-    orders = FileManager::loadOrders();
+    vector<string> skipped;
+    applyStatusChange({orderId}, newStatus, skipped);
+    if (!skipped.empty()) {
+      throw InvalidInputException(skipped.front());
+    }
     cout << Utils::colorText("✓ Order status updated!", "green", "", "bold")
          << endl;
     Utils::pauseScreen();
@@ -720,20 +1304,96 @@ void Application::updateOrderStatus() {
   }
 }
 
-void Application::viewAllUsers() {
-  Utils::clearScreen();
-  Utils::showSubHeader("👥 All Users");
-
-  users = FileManager::loadUsers();
-
-  if (users.empty()) {
-    cout << Utils::colorText("No users registered.", "yellow") << endl;
+void Application::batchUpdateOrderStatus() {
+  cout << endl;
+  cout << "1. Enter order IDs" << endl;
+  cout << "2. All orders matching a filter" << endl;
+  vector<string> orderIds;
+  if (Utils::getIntInput("Choose: ", 1, 2) == 1) {
+    string list =
+        Utils::getStringInput("Order IDs (separated by spaces or commas): ");
+    for (char &c : list) {
+      c = c == ',' ? ' ' : toupper(static_cast<unsigned char>(c));
+    }
+    istringstream ids(list);
+    string id;
+    set<string> seen;
+    while (ids >> id) {
+      if (seen.insert(id).second)
+        orderIds.push_back(id);
+    }
+  } else {
+    orderIds = matchingOrderIds(promptOrderQuery());
+  }
+  if (orderIds.empty()) {
+    cout << Utils::colorText("No orders selected.", "yellow") << endl;
     Utils::pauseScreen();
     return;
   }
 
-  cout << Utils::colorText("Total Users: " + to_string(users.size()), "yellow")
-       << endl
+  cout << endl << Utils::colorText("Select new status:", "yellow") << endl;
+  for (size_t i = 0; i < ORDER_STATUS_COUNT; i++) {
+    cout << (i + 1) << ". "
+         << Order::statusToString(static_cast<OrderStatus>(i)) << endl;
+  }
+  OrderStatus newStatus = static_cast<OrderStatus>(
+      Utils::getIntInput("Choose: ", 1, ORDER_STATUS_COUNT) - 1);
+
+  size_t movable = 0;
+  for (const string &id : orderIds) {
+    const Order *order = findOrder(id);
+    if (order != nullptr && Order::canTransition(order->getStatus(), newStatus))
+      movable++;
+  }
+  cout << orderIds.size() << " order(s) selected, " << movable
+       << " can move to " << Order::statusToString(newStatus) << "." << endl;
+  if (movable == 0) {
+    Utils::pauseScreen();
+    return;
+  }
+  string confirm = Utils::getStringInput("Apply? (yes/no): ");
+  if (confirm != "yes" && confirm != "y") {
+    Utils::pauseScreen();
+    return;
+  }
+
+  try {
+    vector<string> skipped;
+    size_t updated = applyStatusChange(orderIds, newStatus, skipped);
+    cout << Utils::colorText("✓ " + to_string(updated) + " order(s) updated.",
+                             "green", "", "bold")
+         << endl;
+    const size_t SHOWN = 10;
+    for (size_t i = 0; i < skipped.size() && i < SHOWN; i++) {
+      cout << Utils::colorText("  Skipped: " + skipped[i], "yellow") << endl;
+    }
+    if (skipped.size() > SHOWN) {
+      cout << Utils::colorText("  ... and " +
+                                   to_string(skipped.size() - SHOWN) +
+                                   " more skipped",
+                               "yellow")
+           << endl;
+    }
+  } catch (const exception &e) {
+    cout << Utils::colorText("✗ " + string(e.what()), "red") << endl;
+  }
+  Utils::pauseScreen();
+}
+
+void Application::viewAllUsers() {
+  Utils::clearScreen();
+  Utils::showSubHeader("👥 All Users");
+
+  users = FileManager::loadUsers();
+
+  if (users.empty()) {
+    cout << Utils::colorText("No users registered.", "yellow") << endl;
+    Utils::pauseScreen();
+    return;
+  }
+
+  cout << Utils::colorText("Total Users: " + to_string(users.size()), "yellow")
+       << endl
        << endl;
 
   for (const auto &user : users) {
@@ -742,21 +1402,1314 @@ void Application::viewAllUsers() {
          << " " << Utils::colorText(user->getName(), "white", "", "bold")
          << " | " << Utils::colorText(user->getEmail(), "yellow") << " | "
          << Utils::colorText("[" + user->getRole() + "]", roleColor) << endl;
+    if (user->getRole() != "admin") {
+      const CustomerTotals &totals = customerStats.get(user->getId());
+      cout << "     " << totals.orders << " orders, "
+           << totals.getSpend().format() << " spent";
+      if (totals.lastOrderAt > 0)
+        cout << ", last " << Utils::formatTimestamp(totals.lastOrderAt);
+      cout << endl;
+    }
+  }
+
+  cout << endl;
+  if (Utils::getStringInput(
+          "[r]ebuild customer totals from orders, Enter to go back: ") ==
+      "r") {
+    rebuildCustomerStats();
+    cout << Utils::colorText("✓ Customer totals rebuilt from " +
+                                 to_string(orders.size()) + " orders.",
+                             "green")
+         << endl;
+    Utils::pauseScreen();
+  }
+}
+
+void Application::viewSystemStats() {
+  Utils::clearScreen();
+  Utils::showSubHeader("📊 System Statistics");
+
+  cout << Utils::colorText("Catalog", "yellow", "", "bold") << endl;
+  cout << "  Products:        " << products.size() << endl;
+  cout << "  Catalog version: " << catalogVersion << endl;
+  cout << endl;
+
+  SearchCacheStats cache = searchCache.getStats();
+  stringstream hitRate;
+  hitRate << fixed << setprecision(1) << cache.hitRate() * 100 << "%";
+
+  cout << Utils::colorText("Search Cache", "yellow", "", "bold") << endl;
+  cout << "  Entries:         " << cache.entries << " / "
+       << searchCache.getCapacity() << endl;
+  cout << "  Hits:            " << cache.hits << endl;
+  cout << "  Misses:          " << cache.misses << endl;
+  cout << "  Hit rate:        " << Utils::colorText(hitRate.str(), "green")
+       << endl;
+  cout << "  Evictions:       " << cache.evictions << endl;
+  cout << "  Invalidations:   " << cache.invalidations << endl;
+  cout << "  Memory:          " << cache.bytes << " bytes" << endl;
+  cout << endl;
+
+  cout << Utils::colorText("Autocomplete", "yellow", "", "bold") << endl;
+  cout << "  Terms:           " << autocomplete.getTermCount() << endl;
+  cout << "  Trie nodes:      " << autocomplete.getNodeCount() << endl;
+  cout << "  Rebuilds:        " << autocomplete.getRebuildCount() << endl;
+  cout << endl;
+
+  cout << Utils::colorText("Cart Holds", "yellow", "", "bold") << endl;
+  cout << "  Enabled:         " << (settings.cartHoldsEnabled ? "Yes" : "No")
+       << endl;
+  cout << "  Active holds:    " << stockHolds.getActiveCount() << endl;
+  cout << "  Expired holds:   " << stockHolds.getExpiredCount() << endl;
+  cout << endl;
+
+  cout << Utils::colorText("Orders", "yellow", "", "bold") << endl;
+  for (size_t i = 0; i < ORDER_STATUS_COUNT; i++) {
+    OrderStatus status = static_cast<OrderStatus>(i);
+    cout << "  " << left << setw(17) << Order::statusToString(status) + ":"
+         << orderIndex.countByStatus(status) << endl;
+  }
+  cout << endl;
+
+  cout << Utils::colorText("Stock Ledger", "yellow", "", "bold") << endl;
+  cout << "  Entries:         " << stockLedger.getEntryCount() << endl;
+  cout << "  Since snapshot:  " << stockLedger.getEntriesSinceSnapshot()
+       << endl;
+
+  for (const string &id : settings.flashSaleProductIds) {
+    FlashSaleStats flash = inventory.getFlashSaleStats(id);
+    cout << endl;
+    cout << Utils::colorText("Flash Sale " + id, "yellow", "", "bold") << endl;
+    cout << "  Available:       " << flash.available << " in " << flash.pools
+         << " sub-pools" << endl;
+    cout << "  Admitted:        " << flash.admitted << endl;
+    cout << "  Rejected:        " << flash.rejected << endl;
+  }
+
+  Utils::pauseScreen();
+}
+
+void Application::storeSettings() {
+  while (true) {
+    Utils::clearScreen();
+    Utils::showSubHeader("⚙️ Store Settings");
+
+    cout << "1. Cart stock holds: "
+         << Utils::colorText(settings.cartHoldsEnabled ? "ON" : "OFF",
+                             settings.cartHoldsEnabled ? "green" : "red")
+         << endl;
+    cout << "2. Cart hold time:   "
+         << Utils::colorText(to_string(settings.cartHoldTtlSeconds / 60) +
+                                 " min",
+                             "yellow")
+         << endl;
+
+    string flashIds;
+    for (const string &id : settings.flashSaleProductIds)
+      flashIds += (flashIds.empty() ? "" : ", ") + id;
+    cout << "3. Flash sale items: "
+         << Utils::colorText(flashIds.empty() ? "None" : flashIds, "yellow")
+         << endl;
+    cout << "4. Flash sale gate:  "
+         << Utils::colorText(to_string(settings.flashSaleRatePerSecond) +
+                                 " checkouts/s, burst " +
+                                 to_string(settings.flashSaleBurst),
+                             "yellow")
+         << endl;
+    cout << "5. Low stock alerts: below "
+         << Utils::colorText(to_string(settings.lowStockThreshold) + " units",
+                             "yellow")
+         << endl;
+    cout << Utils::colorText("0.", "red", "", "bold") << " Back" << endl
+         << endl;
+
+    int choice = Utils::getIntInput("Choose: ", 0, 5);
+    if (choice == 0)
+      break;
+
+    if (choice == 1) {
+      settings.cartHoldsEnabled = !settings.cartHoldsEnabled;
+    } else if (choice == 2) {
+      settings.cartHoldTtlSeconds =
+          Utils::getIntInput("Hold time (minutes): ", 1, 1440) * 60;
+    } else if (choice == 3) {
+      stringstream ss(Utils::getStringInput(
+          "Product IDs, comma separated (blank to end all): "));
+      vector<string> ids;
+      string id;
+      while (getline(ss, id, ',')) {
+        id.erase(0, id.find_first_not_of(' '));
+        id.erase(id.find_last_not_of(' ') + 1);
+        if (findProductById(id) != nullptr) {
+          ids.push_back(id);
+        } else if (!id.empty()) {
+          cout << Utils::colorText("Skipping unknown product " + id, "yellow")
+               << endl;
+        }
+      }
+      for (const string &old : settings.flashSaleProductIds)
+        inventory.endFlashSale(old);
+      settings.flashSaleProductIds = ids;
+      applyFlashSales();
+    } else if (choice == 4) {
+      settings.flashSaleRatePerSecond =
+          Utils::getIntInput("Checkouts per second: ", 1, 100000);
+      settings.flashSaleBurst = Utils::getIntInput("Burst size: ", 1, 100000);
+      // Restart running sales so the new gate takes effect
+      for (const string &id : settings.flashSaleProductIds)
+        inventory.endFlashSale(id);
+      applyFlashSales();
+    } else {
+      settings.lowStockThreshold =
+          Utils::getIntInput("Alert below (units): ", 1, 100000);
+      stockAlerts.setThreshold(settings.lowStockThreshold, products);
+      facetIndex.setLowStockThreshold(settings.lowStockThreshold, products);
+    }
+
+    try {
+      FileManager::saveSettings(settings);
+    } catch (const exception &e) {
+      cout << Utils::colorText("✗ " + string(e.what()), "red") << endl;
+      Utils::pauseScreen();
+    }
+  }
+}
+
+void Application::viewStockHistory() {
+  Utils::clearScreen();
+  Utils::showSubHeader("📜 Stock History");
+
+  displayProductList();
+
+  string productId = Utils::getStringInput("Enter Product ID: ");
+  const Product *product = findProductById(productId);
+  if (product == nullptr && !stockLedger.hasProduct(productId)) {
+    cout << Utils::colorText("✗ Product not found: " + productId, "red")
+         << endl;
+    Utils::pauseScreen();
+    return;
+  }
+
+  try {
+    vector<StockEvent> events = stockLedger.history(productId, 20);
+
+    cout << endl;
+    if (product != nullptr) {
+      cout << Utils::colorText(product->getName(), "white", "", "bold")
+           << endl;
+    }
+    cout << "Current stock: "
+         << Utils::colorText(to_string(stockLedger.getLevel(productId)),
+                             "green", "", "bold")
+         << endl
+         << endl;
+
+    cout << Utils::colorText(
+                " #      │ Date             │ Type         │ Change │ "
+                "Balance │ Reference",
+                "white", "", "bold")
+         << endl;
+    for (const StockEvent &event : events) {
+      string date = Utils::formatTimestamp(event.timestamp).substr(0, 16);
+      string change = (event.delta > 0 ? "+" : "") + to_string(event.delta);
+
+      cout << " " << left << setw(6) << event.sequence << " │ " << setw(16)
+           << date << " │ " << setw(12)
+           << StockLedger::typeToString(event.type) << " │ "
+           << Utils::colorText(change, event.delta < 0 ? "red" : "green")
+           << string(change.size() < 6 ? 6 - change.size() : 0, ' ')
+           << " │ " << setw(7) << event.balance << " │ " << event.reference
+           << endl;
+    }
+    if (events.empty()) {
+      cout << Utils::colorText("No stock movements recorded.", "yellow")
+           << endl;
+    }
+  } catch (const exception &e) {
+    cout << Utils::colorText("✗ " + string(e.what()), "red") << endl;
+  }
+
+  Utils::pauseScreen();
+}
+
+void Application::viewStockAlerts() {
+  Utils::clearScreen();
+  Utils::showSubHeader("🔔 Stock Alerts");
+
+  size_t unread = stockAlerts.poll(alertSubscriber).size();
+  vector<StockAlert> alerts = stockAlerts.getRecent(20);
+
+  cout << "Alert level: below " << stockAlerts.getThreshold() << " units"
+       << endl
+       << endl;
+
+  if (alerts.empty()) {
+    cout << Utils::colorText("No stock alerts this session.", "green")
+         << endl;
+    Utils::pauseScreen();
+    return;
+  }
+
+  for (size_t i = 0; i < alerts.size(); i++) {
+    const StockAlert &alert = alerts[i];
+    string date = Utils::formatTimestamp(alert.timestamp).substr(0, 16);
+
+    string color = "yellow";
+    if (alert.type == StockAlertType::OUT_OF_STOCK)
+      color = "red";
+    else if (alert.type == StockAlertType::BACK_IN_STOCK)
+      color = "green";
+
+    cout << (i < unread ? Utils::colorText("NEW ", "red", "", "bold") : "    ")
+         << date << "  "
+         << Utils::colorText(StockAlertMonitor::typeToString(alert.type), color,
+                             "", "bold")
+         << "  " << alert.productId << " " << alert.productName << " ("
+         << alert.previousQuantity << " → " << alert.quantity << ")" << endl;
   }
+  cout << endl << "Full log: data/alerts.log" << endl;
 
   Utils::pauseScreen();
 }
 
+void Application::manageWarehouses() {
+  while (true) {
+    Utils::clearScreen();
+    Utils::showSubHeader("🏭 Warehouses");
+
+    const vector<Warehouse> &locations = warehouseStock.getWarehouses();
+    for (const Warehouse &w : locations) {
+      cout << Utils::colorText(w.id, "yellow", "", "bold") << "  " << w.name
+           << (w.region.empty() ? "" : " (" + w.region + ")") << endl;
+    }
+    cout << endl;
+
+    cout << Utils::colorText(" ID     ", "white", "", "bold");
+    for (const Warehouse &w : locations) {
+      cout << Utils::colorText("│ " + w.id.substr(0, 8) +
+                                   string(9 - min<size_t>(w.id.size(), 8), ' '),
+                               "white", "", "bold");
+    }
+    cout << Utils::colorText("│ Total", "white", "", "bold") << endl;
+    for (const Product &p : products) {
+      cout << " " << left << setw(7) << p.getId();
+      for (size_t loc = 0; loc < locations.size(); loc++) {
+        cout << "│ " << setw(9) << warehouseStock.getAt(p.getId(), loc);
+      }
+      cout << "│ " << warehouseStock.getTotal(p.getId()) << endl;
+    }
+
+    cout << endl;
+    cout << "1. Add warehouse" << endl;
+    cout << "2. Transfer stock" << endl;
+    cout << Utils::colorText("0.", "red", "", "bold") << " Back" << endl
+         << endl;
+
+    int choice = Utils::getIntInput("Choose: ", 0, 2);
+    if (choice == 0)
+      break;
+
+    try {
+      if (choice == 1) {
+        Warehouse w;
+        w.id = Utils::getStringInput("Warehouse ID: ");
+        w.name = Utils::getStringInput("Name: ");
+        w.region = Utils::getStringInput("Region (matched in addresses): ");
+        warehouseStock.addWarehouse(w);
+        FileManager::saveWarehouses(warehouseStock.getWarehouses());
+      } else {
+        string productId = Utils::getStringInput("Product ID: ");
+        if (findProductById(productId) == nullptr) {
+          throw ProductNotFoundException("Product not found: " + productId);
+        }
+        cout << "From:" << endl;
+        size_t from = chooseWarehouse(productId);
+        cout << "To:" << endl;
+        size_t to = chooseWarehouse(productId);
+        int quantity = Utils::getIntInput(
+            "Units: ", 1, max(1, warehouseStock.getAt(productId, from)));
+        warehouseStock.add(productId, from, -quantity);
+        warehouseStock.add(productId, to, quantity);
+      }
+      saveWarehouseStock();
+    } catch (const exception &e) {
+      cout << Utils::colorText("✗ " + string(e.what()), "red") << endl;
+      Utils::pauseScreen();
+    }
+  }
+}
+
+void Application::managePromotions() {
+  while (true) {
+    Utils::clearScreen();
+    Utils::showSubHeader("🏷️ Promotions");
+
+    const vector<PromotionRule> &rules = promotions.getRules();
+    if (rules.empty()) {
+      cout << Utils::colorText("No promotions defined in data/promotions.json",
+                               "yellow")
+           << endl;
+    }
+    for (size_t i = 0; i < rules.size(); i++) {
+      const PromotionRule &rule = rules[i];
+      cout << Utils::colorText(to_string(i + 1) + ".", "yellow", "", "bold")
+           << " " << left << setw(6) << rule.id << setw(18)
+           << PromotionEngine::typeToString(rule.type)
+           << Utils::colorText(rule.active ? "[on] " : "[off]",
+                               rule.active ? "green" : "red")
+           << " " << rule.description << endl;
+    }
+
+    cout << endl;
+    cout << "1. Turn a rule on/off" << endl;
+    cout << "2. Reload rules from file" << endl;
+    cout << "3. Reprice saved carts" << endl;
+    cout << Utils::colorText("0.", "red", "", "bold") << " Back" << endl
+         << endl;
+
+    int choice = Utils::getIntInput("Choose: ", 0, 3);
+    if (choice == 0)
+      break;
+
+    try {
+      if (choice == 1) {
+        if (rules.empty()) {
+          throw InvalidInputException("There are no rules to change");
+        }
+        vector<PromotionRule> updated = rules;
+        PromotionRule &rule =
+            updated[Utils::getIntInput("Rule #: ", 1, updated.size()) - 1];
+        rule.active = !rule.active;
+        FileManager::savePromotions(updated);
+        promotions.compile(updated);
+      } else if (choice == 2) {
+        promotions.compile(FileManager::loadPromotions());
+      } else {
+        repriceSavedCarts();
+      }
+    } catch (const exception &e) {
+      cout << Utils::colorText("✗ " + string(e.what()), "red") << endl;
+      Utils::pauseScreen();
+    }
+  }
+}
+
+// ============================================
+// PROMOTIONS
+// ============================================
+
+void Application::displayPricing(const PricedCart &priced) const {
+  if (priced.getDiscount() == Money())
+    return;
+
+  cout << endl << Utils::colorText("Promotions:", "white", "", "bold") << endl;
+  for (const PricedLine &line : priced.lines) {
+    if (line.discount == Money())
+      continue;
+    const Product *product = findProductById(line.productId);
+    cout << "  • " << (product != nullptr ? product->getName() : line.productId)
+         << " (" << line.ruleId << "): "
+         << Utils::colorText("-" + line.discount.format(), "green") << endl;
+  }
+  if (priced.couponDiscount > Money()) {
+    cout << "  • Coupon (" << priced.couponRuleId << "): "
+         << Utils::colorText("-" + priced.couponDiscount.format(), "green")
+         << endl;
+  }
+  cout << "Subtotal: " << priced.subtotal.format() << endl;
+  cout << "You save: "
+       << Utils::colorText(priced.getDiscount().format(), "green") << endl;
+  cout << Utils::colorText("Total:    " + priced.total.format(), "green", "",
+                           "bold")
+       << endl;
+}
+
+// Prices every saved customer cart against the current rules, e.g. to see
+// what a rule change is worth before announcing it
+void Application::repriceSavedCarts() {
+  vector<Cart> carts;
+  for (int customerId : CartStore::listCustomers()) {
+    carts.push_back(CartStore::load(customerId));
+  }
+  vector<const Cart *> batch;
+  batch.reserve(carts.size());
+  for (const Cart &cart : carts) {
+    batch.push_back(&cart);
+  }
+
+  unsigned threads = min<size_t>(max(1u, thread::hardware_concurrency()),
+                                 max<size_t>(1, batch.size()));
+  auto started = chrono::steady_clock::now();
+  vector<PricedCart> priced =
+      promotions.repriceAll(batch, productLookup(), threads);
+  double elapsedMs = chrono::duration<double, milli>(
+                         chrono::steady_clock::now() - started)
+                         .count();
+
+  Money subtotal;
+  Money discount;
+  for (const PricedCart &cart : priced) {
+    subtotal += cart.subtotal;
+    discount += cart.getDiscount();
+  }
+
+  cout << endl;
+  cout << "Saved carts:     " << priced.size() << endl;
+  cout << "Cart value:      " << subtotal.format() << endl;
+  cout << "Promotions save: " << Utils::colorText(discount.format(), "green")
+       << endl;
+  stringstream elapsed;
+  elapsed << fixed << setprecision(2) << elapsedMs << " ms";
+  cout << "Repriced in " << elapsed.str() << " on " << threads
+       << " thread(s)" << endl;
+  Utils::pauseScreen();
+}
+
+// Asks which orders to list; Enter skips a filter
+OrderQuery Application::promptOrderQuery() {
+  OrderQuery query;
+  cout << "1. All orders" << endl;
+  cout << "2. Filter (status, customer, dates, total)" << endl;
+  if (Utils::getIntInput("Choose: ", 1, 2) == 1)
+    return query;
+
+  cout << Utils::colorText("Press Enter to skip a filter.", "yellow") << endl;
+  while (true) {
+    string status = Utils::getStringInput(
+        "Status (Pending/Confirmed/Processing/Shipped/Delivered/Cancelled): ");
+    if (status.empty())
+      break;
+    OrderStatus parsed;
+    if (Order::parseStatus(status, parsed)) {
+      query.statuses.push_back(parsed);
+      break;
+    }
+    cout << Utils::colorText("✗ Unknown status: " + status, "red") << endl;
+  }
+
+  string customer = Utils::getStringInput("Customer ID: ");
+  if (!customer.empty()) {
+    try {
+      query.customerId = stoi(customer);
+    } catch (const exception &) {
+      cout << Utils::colorText("Ignoring customer ID: " + customer, "yellow")
+           << endl;
+    }
+  }
+
+  string from = Utils::getStringInput("From date (YYYY-MM-DD): ");
+  string to = Utils::getStringInput("To date (YYYY-MM-DD): ");
+  if (!from.empty() || !to.empty()) {
+    int64_t fromEpoch = from.empty() ? 0 : Utils::parseTimestamp(from);
+    int64_t toEpoch = to.empty() ? INT64_MAX : Utils::parseTimestamp(to);
+    if (fromEpoch < 0 || toEpoch < 0) {
+      cout << Utils::colorText("Ignoring date filter - use YYYY-MM-DD",
+                               "yellow")
+           << endl;
+    } else {
+      query.filterDates = true;
+      query.createdFrom = fromEpoch;
+      // A bare "to" date includes that whole day
+      query.createdTo = to.size() == 10 ? toEpoch + 86399 : toEpoch;
+    }
+  }
+
+  string minTotal = Utils::getStringInput("Min total: $");
+  string maxTotal = Utils::getStringInput("Max total: $");
+  if (!minTotal.empty() || !maxTotal.empty()) {
+    try {
+      query.minTotal = minTotal.empty() ? Money() : Money::parse(minTotal);
+      query.maxTotal = maxTotal.empty() ? Money::fromCents(INT64_MAX)
+                                        : Money::parse(maxTotal);
+      query.filterTotals = true;
+    } catch (const exception &) {
+      cout << Utils::colorText("Ignoring total filter", "yellow") << endl;
+    }
+  }
+  return query;
+}
+
+// Pages through the orders matching the query, newest first. Returns the
+// order ID the user picks, or "" when they go back.
+string Application::pickOrder(const OrderQuery &query, const string &title) {
+  const size_t PAGE_SIZE = 10;
+  size_t matches = orderIndex.count(query);
+  size_t pageCount = max<size_t>(1, (matches + PAGE_SIZE - 1) / PAGE_SIZE);
+  vector<OrderCursor> cursors(1);
+  size_t pageNumber = 0;
+
+  while (true) {
+    OrderCursor next;
+    vector<uint32_t> slots =
+        orderIndex.page(query, cursors[pageNumber], PAGE_SIZE, next);
+    if (cursors.size() == pageNumber + 1)
+      cursors.push_back(next);
+
+    Utils::clearScreen();
+    Utils::showSubHeader(title);
+
+    if (slots.empty()) {
+      cout << Utils::colorText("No orders found.", "yellow") << endl;
+    } else {
+      cout << Utils::colorText("Page " + to_string(pageNumber + 1) + " of " +
+                                   to_string(pageCount) + " (" +
+                                   to_string(matches) + " orders)",
+                               "yellow")
+           << endl
+           << endl;
+      for (uint32_t slot : slots) {
+        orders[slot].displayShort();
+      }
+    }
+
+    bool hasNext = pageNumber + 1 < pageCount;
+    string input = Utils::getStringInput(
+        string("\nOrder ID to open, ") + (hasNext ? "[n]ext, " : "") +
+        (pageNumber > 0 ? "[p]revious, " : "") + "[b]ack: ");
+
+    if (input == "n" && hasNext) {
+      pageNumber++;
+    } else if (input == "p" && pageNumber > 0) {
+      pageNumber--;
+    } else if (input == "b" || input == "back") {
+      return "";
+    } else if (orderIndex.find(input) >= 0 &&
+               (query.customerId == 0 ||
+                findOrder(input)->getCustomerId() == query.customerId)) {
+      return input;
+    } else if (!input.empty()) {
+      cout << Utils::colorText("✗ Order not found: " + input, "red") << endl;
+      Utils::pauseScreen();
+    }
+  }
+}
+
+void Application::viewSalesReports() {
+  while (true) {
+    Utils::clearScreen();
+    Utils::showSubHeader("📈 Sales Reports");
+
+    RollupRow totals = salesRollup.getTotals();
+    cout << "Revenue: " << Utils::colorText(totals.revenue.format(), "green")
+         << "   Orders: " << totals.orders << "   Units: " << totals.units
+         << endl
+         << endl;
+
+    cout << "1. By day (last 14 days)" << endl;
+    cout << "2. Top products" << endl;
+    cout << "3. By category" << endl;
+    cout << "4. Best sellers (last hour / day / week)" << endl;
+    cout << "5. Distinct customers by product and category" << endl;
+    cout << Utils::colorText("0.", "red", "", "bold") << " Back" << endl
+         << endl;
+
+    int choice = Utils::getIntInput("Choose: ", 0, 5);
+    if (choice == 0)
+      break;
+    if (choice == 5) {
+      viewCustomerReach();
+      continue;
+    }
+    if (choice == 4) {
+      cout << endl;
+      displayBestSellers(SalesWindow::LAST_HOUR, 10);
+      displayBestSellers(SalesWindow::LAST_DAY, 10);
+      displayBestSellers(SalesWindow::LAST_WEEK, 10);
+      Utils::pauseScreen();
+      continue;
+    }
+
+    vector<pair<string, RollupRow>> rows;
+    string heading;
+    if (choice == 1) {
+      rows = salesRollup.recentDays(14);
+      heading = "Day";
+    } else if (choice == 2) {
+      rows = salesRollup.topProducts(10);
+      heading = "Product";
+    } else {
+      rows = salesRollup.topCategories(20);
+      heading = "Category";
+    }
+
+    cout << endl;
+    cout << Utils::colorText(" " + heading +
+                                 string(max<size_t>(1, 23 - heading.size()),
+                                        ' ') +
+                                 "│ Revenue       │ Units   │ Orders",
+                             "white", "", "bold")
+         << endl;
+    for (const auto &row : rows) {
+      string label = row.first;
+      if (choice == 2) {
+        const Product *product = findProductById(row.first);
+        if (product != nullptr)
+          label += " " + product->getName();
+      }
+      cout << " " << left << setw(22) << label.substr(0, 22) << " │ "
+           << setw(13) << row.second.revenue.format() << " │ " << setw(7)
+           << row.second.units << " │ " << row.second.orders << endl;
+    }
+    if (rows.empty()) {
+      cout << Utils::colorText(" No sales yet.", "yellow") << endl;
+    }
+    Utils::pauseScreen();
+  }
+}
+
+void Application::viewCustomerReach() {
+  int months = Utils::getIntInput("Months back (0 = all time): ", 0, 120);
+  string fromMonth;
+  if (months > 0) {
+    // First month of the range, counting this month as one
+    string current = Utils::formatTimestamp(Utils::currentEpoch());
+    int index = stoi(current.substr(0, 4)) * 12 +
+                stoi(current.substr(5, 2)) - 1 - (months - 1);
+    ostringstream month;
+    month << index / 12 << '-' << setw(2) << setfill('0') << index % 12 + 1;
+    fromMonth = month.str();
+  }
+
+  auto printRows = [&](const string &heading, const vector<ReachRow> &rows,
+                       bool products) {
+    cout << endl
+         << Utils::colorText(" " + heading + string(23 - heading.size(), ' ') +
+                                 "│ Customers",
+                             "white", "", "bold")
+         << endl;
+    for (const ReachRow &row : rows) {
+      string label = row.first;
+      const Product *product = products ? findProductById(row.first) : nullptr;
+      if (product != nullptr)
+        label += " " + product->getName();
+      cout << " " << left << setw(22) << label.substr(0, 22) << " │ ~"
+           << llround(row.second) << endl;
+    }
+    if (rows.empty())
+      cout << Utils::colorText(" No sales yet.", "yellow") << endl;
+  };
+
+  cout << endl
+       << Utils::colorText(fromMonth.empty() ? "All time"
+                                             : "Since " + fromMonth,
+                           "yellow", "", "bold")
+       << endl;
+  printRows("Product", customerReach.topProducts(fromMonth, 10), true);
+  printRows("Category", customerReach.topCategories(fromMonth, 10), false);
+
+  ostringstream bound;
+  bound << fixed << setprecision(1)
+        << HyperLogLog().getStandardError() * 200;
+  cout << endl
+       << "Estimates are within ±" << bound.str()
+       << "% (two standard errors). "
+       << customerReach.getSketchCount() << " sketches, "
+       << customerReach.memoryBytes() << " bytes." << endl;
+  Utils::pauseScreen();
+}
+
+void Application::viewOrderAnalytics() {
+  while (true) {
+    Utils::clearScreen();
+    Utils::showSubHeader("🔬 Order Analytics");
+
+    cout << "1. Revenue by product" << endl;
+    cout << "2. Revenue by customer" << endl;
+    cout << "3. Benchmark on synthetic history" << endl;
+    cout << Utils::colorText("0.", "red", "", "bold") << " Back" << endl
+         << endl;
+
+    int choice = Utils::getIntInput("Choose: ", 0, 3);
+    if (choice == 0)
+      break;
+    if (choice == 3) {
+      runAnalyticsBenchmark();
+      continue;
+    }
+
+    // Exported fresh from the in-memory orders for each query
+    OrderLineStore lines;
+    lines.build(orders);
+
+    LineFilter filter;
+    string from =
+        Utils::getStringInput("From date (YYYY-MM-DD, Enter = all): ");
+    string to = Utils::getStringInput("To date (YYYY-MM-DD, Enter = all): ");
+    if (!from.empty() && Utils::parseTimestamp(from) >= 0)
+      filter.from = Utils::parseTimestamp(from);
+    if (!to.empty() && Utils::parseTimestamp(to) >= 0)
+      filter.to = Utils::parseTimestamp(to) + 86399;
+
+    LineGroupBy groupBy =
+        choice == 1 ? LineGroupBy::PRODUCT : LineGroupBy::CUSTOMER;
+    vector<LineGroup> groups = lines.aggregate(filter, groupBy);
+
+    cout << endl;
+    cout << Utils::colorText(string(groupBy == LineGroupBy::PRODUCT
+                                        ? " Product "
+                                        : " Customer") +
+                                 "│ Revenue       │ Units   │ Lines",
+                             "white", "", "bold")
+         << endl;
+    for (size_t i = 0; i < groups.size() && i < 15; i++) {
+      const LineGroup &g = groups[i];
+      string key = groupBy == LineGroupBy::PRODUCT
+                       ? lines.productIdOf(g.key)
+                       : to_string(g.key);
+      cout << " " << left << setw(8) << key << "│ " << setw(13)
+           << Money::fromCents(g.revenueCents).format() << " │ " << setw(7)
+           << g.units << " │ " << g.lines << endl;
+    }
+    if (groups.empty()) {
+      cout << Utils::colorText(" No order lines match.", "yellow") << endl;
+    }
+    cout << endl
+         << lines.size() << " lines from " << lines.getOrderCount()
+         << " orders scanned" << endl;
+    Utils::pauseScreen();
+  }
+}
+
+// Times the group-by kernel over generated order lines, single-threaded
+// and on every hardware thread
+void Application::runAnalyticsBenchmark() {
+  int millions = Utils::getIntInput("Order lines (millions, 1-10): ", 1, 10);
+  size_t rows = static_cast<size_t>(millions) * 1000000;
+
+  cout << "Generating " << rows << " order lines..." << endl;
+  OrderLineStore lines;
+  lines.reserve(rows);
+  mt19937_64 rng(42);
+  const int64_t YEAR = 365LL * 86400;
+  int64_t now = Utils::currentEpoch();
+  size_t row = 0;
+  for (uint64_t order = 0; row < rows; order++) {
+    string orderId = "SYN" + to_string(order);
+    int32_t customerId = 1 + rng() % 50000;
+    int64_t placedAt = now - static_cast<int64_t>(rng() % YEAR);
+    bool isCancelled = rng() % 20 == 0;
+    for (int line = 1 + rng() % 4; line > 0 && row < rows; line--, row++) {
+      lines.appendLine(orderId, customerId, "P" + to_string(rng() % 2000),
+                       1 + rng() % 5, 99 + rng() % 200000, placedAt,
+                       isCancelled);
+    }
+  }
+
+  LineFilter lastQuarter;
+  lastQuarter.from = now - 90 * 86400;
+  unsigned hardware = max(1u, thread::hardware_concurrency());
+
+  auto timeRun = [&](LineGroupBy groupBy, unsigned threads) {
+    auto started = chrono::steady_clock::now();
+    size_t groups = lines.aggregate(lastQuarter, groupBy, threads).size();
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() -
+                                                started)
+                    .count();
+    stringstream result;
+    result << fixed << setprecision(1) << ms << " ms, "
+           << setprecision(0) << rows / (ms / 1000.0) / 1e6
+           << " M rows/s, " << groups << " groups";
+    return result.str();
+  };
+
+  cout << endl;
+  cout << Utils::colorText("Last 90 days, cancelled orders excluded", "yellow")
+       << endl;
+  cout << "Threads available: " << hardware << endl;
+  cout << "By product,  1 thread:    " << timeRun(LineGroupBy::PRODUCT, 1)
+       << endl;
+  cout << "By product,  all threads: "
+       << timeRun(LineGroupBy::PRODUCT, hardware) << endl;
+  cout << "By customer, 1 thread:    " << timeRun(LineGroupBy::CUSTOMER, 1)
+       << endl;
+  cout << "By customer, all threads: "
+       << timeRun(LineGroupBy::CUSTOMER, hardware) << endl;
+  cout << "Column memory: " << lines.memoryBytes() / (1024 * 1024) << " MB"
+       << endl;
+  Utils::pauseScreen();
+}
+
+// ============================================
+// SALES ROLLUPS
+// ============================================
+
+// Uses the saved rollups when they were built from the current order
+// list; otherwise (first run, edited orders file) rebuilds them once
+void Application::loadSalesRollups() {
+  try {
+    salesRollup.load(FileManager::loadSalesRollups());
+  } catch (const exception &e) {
+    cout << Utils::colorText("Warning: " + string(e.what()), "yellow") << endl;
+  }
+  if (!salesRollup.matches(orders.size(),
+                           orderIndex.countByStatus(OrderStatus::CANCELLED))) {
+    salesRollup.rebuild(orders, productLookup());
+    saveSalesRollups();
+  }
+}
+
+void Application::saveSalesRollups() const {
+  try {
+    FileManager::saveSalesRollups(salesRollup.getTables());
+  } catch (const exception &e) {
+    cout << Utils::colorText("Warning: " + string(e.what()), "yellow") << endl;
+  }
+}
+
+// ============================================
+// RECOMMENDATIONS
+// ============================================
+
+// Serves the saved lists when they match the order list; otherwise
+// rebuilds them from every order
+void Application::loadRecommendations() {
+  if (recommender.load(orders.size()))
+    return;
+  recommender.build(orders);
+  saveRecommendations();
+}
+
+void Application::saveRecommendations() const {
+  try {
+    recommender.save();
+  } catch (const exception &e) {
+    cout << Utils::colorText("Warning: " + string(e.what()), "yellow") << endl;
+  }
+}
+
+// Products most often bought with any of `productIds`, leaving out the
+// products themselves, anything in the cart and anything unavailable
+void Application::displayRecommendations(
+    const vector<string> &productIds) const {
+  const size_t SHOWN = 3;
+  map<string, uint32_t> scores;
+  for (const string &id : productIds) {
+    for (const Neighbour &n : recommender.recommend(id))
+      scores[n.productId] += n.count;
+  }
+  for (const string &id : productIds)
+    scores.erase(id);
+
+  vector<pair<const Product *, uint32_t>> ranked;
+  for (const auto &entry : scores) {
+    const Product *product = findProductById(entry.first);
+    if (product != nullptr && !currentCart.hasProduct(entry.first) &&
+        inventory.getAvailable(entry.first) > 0)
+      ranked.push_back({product, entry.second});
+  }
+  if (ranked.empty())
+    return;
+  sort(ranked.begin(), ranked.end(),
+       [](const pair<const Product *, uint32_t> &a,
+          const pair<const Product *, uint32_t> &b) {
+         return a.second > b.second;
+       });
+
+  cout << endl
+       << Utils::colorText("Frequently bought together:", "blue", "", "bold")
+       << endl;
+  for (size_t i = 0; i < ranked.size() && i < SHOWN; i++) {
+    const Product *product = ranked[i].first;
+    cout << "  " << Utils::colorText(product->getId(), "yellow") << "  "
+         << product->getName() << "  "
+         << Utils::colorText(product->getPrice().format(), "green") << endl;
+  }
+}
+
+// ============================================
+// BEST SELLERS
+// ============================================
+
+// The tracker is in-memory only; at startup it replays the last week of
+// orders. The order index pages through that week's slot window only, so
+// the cost follows the week's orders, not the whole history. Later
+// cancellations are not taken back out - the windows age them out.
+void Application::warmBestSellers() {
+  bestSellers.clear();
+  int64_t now = Utils::currentEpoch();
+  OrderQuery query;
+  query.filterDates = true;
+  query.createdFrom = now - 7 * 24 * 60 * 60;
+  query.createdTo = now;
+  for (size_t status = 0; status < ORDER_STATUS_COUNT; status++) {
+    if (static_cast<OrderStatus>(status) != OrderStatus::CANCELLED)
+      query.statuses.push_back(static_cast<OrderStatus>(status));
+  }
+
+  OrderCursor cursor;
+  while (true) {
+    OrderCursor next;
+    vector<uint32_t> slots = orderIndex.page(query, cursor, 256, next);
+    for (uint32_t slot : slots) {
+      for (const OrderItem &item : orders[slot].getItems()) {
+        bestSellers.record(item.productId, item.quantity,
+                           orders[slot].getCreatedAt());
+      }
+    }
+    if (slots.size() < 256)
+      break;
+    cursor = next;
+  }
+}
+
+void Application::displayBestSellers(SalesWindow window, size_t limit) const {
+  vector<HeavyHitter> top =
+      bestSellers.top(window, Utils::currentEpoch(), limit);
+  if (top.empty())
+    return;
+
+  cout << Utils::colorText("🔥 Top sellers - " +
+                               BestSellerTracker::windowToString(window),
+                           "yellow", "", "bold")
+       << endl;
+  for (const HeavyHitter &hit : top) {
+    const Product *product = findProductById(hit.productId);
+    cout << "  " << Utils::colorText(hit.productId, "yellow") << "  "
+         << (product != nullptr ? product->getName() : "(removed)") << "  "
+         << hit.units << " sold";
+    if (hit.error > 0)
+      cout << Utils::colorText(" (±" + to_string(hit.error) + ")", "white");
+    cout << endl;
+  }
+  cout << endl;
+}
+
+// ============================================
+// ORDER STATUS
+// ============================================
+
+// Moves every listed order that may make the move (per the order state
+// machine) to `newStatus`; the rest are reported in `skipped`. All
+// changes are saved in one write of the orders file, and if that fails
+// every order is put back. Side effects of cancelling (stock returns,
+// sales rollups) follow, with each affected file written once.
+size_t Application::applyStatusChange(const vector<string> &orderIds,
+                                      OrderStatus newStatus,
+                                      vector<string> &skipped) {
+  vector<pair<Order *, Order>> changed; // Order, copy from before
+  changed.reserve(orderIds.size());
+  for (const string &id : orderIds) {
+    Order *order = findOrder(id);
+    if (order == nullptr) {
+      skipped.push_back("Order not found: " + id);
+      continue;
+    }
+    if (!Order::canTransition(order->getStatus(), newStatus)) {
+      skipped.push_back(id + " is " + order->getStatusString() +
+                        " and cannot become " +
+                        Order::statusToString(newStatus));
+      continue;
+    }
+    changed.push_back({order, *order});
+    order->updateStatus(newStatus);
+  }
+  if (changed.empty())
+    return 0;
+
+  try {
+    FileManager::saveOrders(orders);
+  } catch (...) {
+    for (auto &entry : changed)
+      *entry.first = entry.second;
+    throw;
+  }
+
+  for (const auto &entry : changed)
+    orderIndex.updateStatus(entry.first->getId(), newStatus);
+
+  // Cancelling puts the orders' units back on the shelf
+  if (newStatus == OrderStatus::CANCELLED) {
+    for (const auto &entry : changed) {
+      const Order &order = *entry.first;
+      for (const OrderItem &item : order.getItems()) {
+        if (findProductById(item.productId) == nullptr)
+          continue;
+        recordStockMovement(item.productId, StockEventType::CANCELLATION,
+                            item.quantity, order.getId());
+        // Returns are received at the first (main) warehouse
+        warehouseStock.add(item.productId, 0, item.quantity);
+        uint64_t &units = unitsSold[item.productId];
+        units -= min<uint64_t>(units, item.quantity);
+      }
+      salesRollup.orderCancelled(order, productLookup());
+      customerStats.orderCancelled(order);
+    }
+    FileManager::saveProducts(products);
+    saveWarehouseStock();
+    saveSalesRollups();
+    // One record rewritten in place for a single order, else one save
+    if (changed.size() == 1) {
+      persistCustomerStats(changed.front().first->getCustomerId());
+    } else {
+      saveCustomerStats();
+    }
+  }
+  return changed.size();
+}
+
+// Every order the query matches, newest first
+vector<string> Application::matchingOrderIds(const OrderQuery &query) const {
+  const size_t PAGE_SIZE = 256;
+  vector<string> orderIds;
+  OrderCursor cursor;
+  while (true) {
+    OrderCursor next;
+    vector<uint32_t> slots = orderIndex.page(query, cursor, PAGE_SIZE, next);
+    for (uint32_t slot : slots)
+      orderIds.push_back(orders[slot].getId());
+    if (slots.size() < PAGE_SIZE)
+      break;
+    cursor = next;
+  }
+  return orderIds;
+}
+
+// ============================================
+// CUSTOMER STATS
+// ============================================
+
+// Saved totals are used when they were built from the current order
+// list; otherwise they are rebuilt once
+void Application::loadCustomerStats() {
+  try {
+    customerStats.load();
+  } catch (const exception &e) {
+    cout << Utils::colorText("Warning: " + string(e.what()), "yellow") << endl;
+  }
+  if (!customerStats.matches(orders.size(),
+                             orderIndex.countByStatus(OrderStatus::CANCELLED)))
+    rebuildCustomerStats();
+}
+
+void Application::persistCustomerStats(int customerId) const {
+  try {
+    customerStats.persist(customerId);
+  } catch (const exception &e) {
+    cout << Utils::colorText("Warning: " + string(e.what()), "yellow") << endl;
+  }
+}
+
+void Application::saveCustomerStats() const {
+  try {
+    customerStats.save();
+  } catch (const exception &e) {
+    cout << Utils::colorText("Warning: " + string(e.what()), "yellow") << endl;
+  }
+}
+
+void Application::rebuildCustomerStats() {
+  customerStats.rebuild(orders);
+  saveCustomerStats();
+}
+
 // ============================================
 // HELPERS
 // ============================================
 
+Order *Application::findOrder(const string &orderId) {
+  int slot = orderIndex.find(orderId);
+  return slot < 0 ? nullptr : &orders[slot];
+}
+
+ProductLookup Application::productLookup() const {
+  return [this](const string &productId) { return findProductById(productId); };
+}
+
+string Application::adminReference() const {
+  return "admin #" + to_string(currentUser->getId());
+}
+
 Product *Application::findProductById(const string &productId) {
-  for (auto &p : products) {
-    if (p.getId() == productId) {
-      return &p;
+  auto it = productSlots.find(productId);
+  return it == productSlots.end() ? nullptr : &products[it->second];
+}
+
+const Product *Application::findProductById(const string &productId) const {
+  auto it = productSlots.find(productId);
+  return it == productSlots.end() ? nullptr : &products[it->second];
+}
+
+// Positions in `products` from `from` onwards have moved; re-record them
+void Application::reindexProducts(size_t from) {
+  if (from == 0)
+    productSlots.clear();
+  for (size_t i = from; i < products.size(); i++)
+    productSlots[products[i].getId()] = i;
+}
+
+// ============================================
+// STOCK LEDGER
+// ============================================
+
+// The ledger is the system of record for stock. Products it has never
+// seen get an opening balance; any other difference means products.json
+// missed a write, so the replayed level wins.
+void Application::reconcileStockLedger() {
+  bool corrected = false;
+  for (Product &p : products) {
+    if (!stockLedger.hasProduct(p.getId())) {
+      stockLedger.record(p.getId(), StockEventType::ADJUSTMENT,
+                         p.getQuantity(), "opening balance");
+    } else if (stockLedger.getLevel(p.getId()) != p.getQuantity()) {
+      p.setQuantity(stockLedger.getLevel(p.getId()));
+      corrected = true;
     }
   }
-  return nullptr;
+  if (corrected)
+    FileManager::saveProducts(products);
+}
+
+// Append a movement and push the resulting level into the catalog; the
+// caller saves products.json
+void Application::recordStockMovement(const string &productId,
+                                      StockEventType type, int delta,
+                                      const string &reference) {
+  int level = stockLedger.record(productId, type, delta, reference);
+  Product *p = findProductById(productId);
+  if (p == nullptr)
+    return;
+  Product updated = *p;
+  updated.setQuantity(level);
+  onProductChanged(updated);
+}
+
+// ============================================
+// WAREHOUSES
+// ============================================
+
+// Location totals follow the ledger level; stock the locations do not
+// account for yet (first run, missed write) lands in the main warehouse
+void Application::reconcileWarehouseStock() {
+  bool changed = false;
+  for (const Product &p : products) {
+    if (warehouseStock.reconcile(p.getId(), p.getQuantity()))
+      changed = true;
+  }
+  if (changed)
+    saveWarehouseStock();
+}
+
+void Application::saveWarehouseStock() const {
+  FileManager::saveWarehouseStock(warehouseStock.toMap());
+}
+
+size_t Application::chooseWarehouse(const string &productId) const {
+  const vector<Warehouse> &locations = warehouseStock.getWarehouses();
+  if (locations.size() == 1)
+    return 0;
+
+  for (size_t i = 0; i < locations.size(); i++) {
+    cout << "  " << i + 1 << ". " << locations[i].name << " ("
+         << warehouseStock.getAt(productId, i) << " units)" << endl;
+  }
+  return Utils::getIntInput("Warehouse: ", 1, locations.size()) - 1;
+}
+
+string Application::shippingAddress() const {
+  shared_ptr<Customer> customer = dynamic_pointer_cast<Customer>(currentUser);
+  return customer != nullptr ? customer->getAddress() : "";
 }
 
+// ============================================
+// CATALOG INDEX MAINTENANCE
+// ============================================
+
+void Application::rebuildIndexes() {
+  catalogVersion++;
+  reindexProducts(0);
+  inventory.load(products);
+  stockAlerts.setThreshold(settings.lowStockThreshold, products);
+  applyFlashSales();
+  facetIndex.setLowStockThreshold(settings.lowStockThreshold, products);
+
+  vector<SortedIndex<Money>::Entry> priceEntries;
+  vector<SortedIndex<string>::Entry> nameEntries;
+  for (const Product &p : products) {
+    priceEntries.push_back({p.getPrice(), p.getId()});
+    nameEntries.push_back({nameKey(p.getName()), p.getId()});
+  }
+  priceIndex.rebuild(priceEntries);
+  nameIndex.rebuild(nameEntries);
+  scheduleAutocompleteRebuild();
+}
+
+string Application::nameKey(const string &name) {
+  string key = name;
+  for (char &c : key)
+    c = tolower(c);
+  return key;
+}
+
+void Application::applyFlashSales() {
+  for (const string &id : settings.flashSaleProductIds) {
+    if (findProductById(id) != nullptr) {
+      inventory.startFlashSale(id, settings.flashSaleRatePerSecond,
+                               settings.flashSaleBurst);
+    }
+  }
+}
+
+// Snapshot names and categories with their popularity and hand them to
+// the background builder; searches keep using the previous trie until
+// the new one is swapped in
+void Application::scheduleAutocompleteRebuild() {
+  vector<Completion> terms;
+  unordered_map<string, uint64_t> categoryWeights;
+
+  for (const Product &p : products) {
+    auto sold = unitsSold.find(p.getId());
+    uint64_t weight = 1 + (sold != unitsSold.end() ? sold->second : 0);
+    terms.push_back({p.getName(), weight});
+    categoryWeights[p.getCategory()] += weight;
+  }
+  for (const auto &entry : categoryWeights) {
+    terms.push_back({entry.first, entry.second});
+  }
+
+  autocomplete.requestRebuild(move(terms));
+}
+
+// Every product write goes through here so the in-memory catalog and its
+// indexes stay in step without reloading the products file
+void Application::onProductChanged(const Product &product) {
+  Product *existing = findProductById(product.getId());
+  bool termsChanged = existing == nullptr ||
+                      existing->getName() != product.getName() ||
+                      existing->getCategory() != product.getCategory();
+  int previousQuantity = existing != nullptr ? existing->getQuantity() : 0;
+  if (existing != nullptr) {
+    *existing = product;
+  } else {
+    products.push_back(product);
+    productSlots[product.getId()] = products.size() - 1;
+  }
+  catalogVersion++;
+  cartFeed.publish(product.getId());
+  inventory.setOnHand(product.getId(), product.getQuantity());
+  facetIndex.upsert(product);
+  priceIndex.upsert(product.getId(), product.getPrice());
+  nameIndex.upsert(product.getId(), nameKey(product.getName()));
+  stockAlerts.observe(product, previousQuantity);
+  if (termsChanged)
+    scheduleAutocompleteRebuild();
+}
+
+void Application::onProductRemoved(const string &productId) {
+  auto slot = productSlots.find(productId);
+  if (slot != productSlots.end()) {
+    // Erase rather than swap with the last product, so the catalog keeps
+    // its order; only the products after it need re-recording
+    size_t position = slot->second;
+    productSlots.erase(slot);
+    products.erase(products.begin() + position);
+    reindexProducts(position);
+  }
+  catalogVersion++;
+  cartFeed.publish(productId);
+  inventory.removeProduct(productId);
+  stockAlerts.forget(productId);
+  facetIndex.remove(productId);
+  priceIndex.remove(productId);
+  nameIndex.remove(productId);
+  scheduleAutocompleteRebuild();
+}
@@ -0,0 +1,224 @@
+#include "../include/autocomplete.h"
+#include <algorithm>
+#include <map>
+
+// ============================================
+// COMPLETION TRIE - BUILD
+// ============================================
+
+shared_ptr<const CompletionTrie>
+CompletionTrie::build(vector<Completion> input) {
+  auto trie = make_shared<CompletionTrie>();
+
+  // Lowercase keys; terms sharing a key keep the first spelling and
+  // add up their weights
+  map<string, Completion> byKey;
+  for (Completion &c : input) {
+    string key = c.text;
+    for (char &ch : key)
+      ch = tolower(static_cast<unsigned char>(ch));
+    if (key.empty())
+      continue;
+
+    auto it = byKey.find(key);
+    if (it == byKey.end()) {
+      byKey.emplace(key, move(c));
+    } else {
+      it->second.weight += c.weight;
+    }
+  }
+
+  // Temporary pointer-free trie: children kept sorted per node
+  struct BuildNode {
+    map<char, uint32_t> children;
+    int term = -1;
+  };
+  vector<BuildNode> buildNodes(1);
+
+  for (auto &entry : byKey) {
+    uint32_t node = 0;
+    for (char ch : entry.first) {
+      auto child = buildNodes[node].children.find(ch);
+      if (child == buildNodes[node].children.end()) {
+        uint32_t next = buildNodes.size();
+        buildNodes[node].children[ch] = next;
+        buildNodes.emplace_back();
+        node = next;
+      } else {
+        node = child->second;
+      }
+    }
+    buildNodes[node].term = trie->terms.size();
+    trie->terms.push_back(move(entry.second));
+  }
+
+  // Flatten in BFS order so each node's edges are contiguous
+  vector<uint32_t> order;
+  vector<uint32_t> flatIndex(buildNodes.size());
+  order.push_back(0);
+  for (size_t i = 0; i < order.size(); i++) {
+    flatIndex[order[i]] = i;
+    for (const auto &child : buildNodes[order[i]].children)
+      order.push_back(child.second);
+  }
+
+  trie->nodes.resize(order.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    const BuildNode &bn = buildNodes[order[i]];
+    Node &node = trie->nodes[i];
+    node.firstEdge = trie->edgeLabels.size();
+    node.edgeCount = bn.children.size();
+    for (const auto &child : bn.children) {
+      trie->edgeLabels.push_back(child.first);
+      trie->edgeTargets.push_back(flatIndex[child.second]);
+    }
+  }
+
+  // Top-k lists bottom-up: children always come after parents in BFS
+  // order, so walking backwards sees every child before its parent
+  vector<vector<uint32_t>> tops(order.size());
+  auto better = [&](uint32_t a, uint32_t b) {
+    if (trie->terms[a].weight != trie->terms[b].weight)
+      return trie->terms[a].weight > trie->terms[b].weight;
+    return a < b;
+  };
+
+  for (size_t i = order.size(); i-- > 0;) {
+    vector<uint32_t> candidates;
+    if (buildNodes[order[i]].term >= 0)
+      candidates.push_back(buildNodes[order[i]].term);
+
+    const Node &node = trie->nodes[i];
+    for (uint32_t e = 0; e < node.edgeCount; e++) {
+      const vector<uint32_t> &childTop =
+          tops[trie->edgeTargets[node.firstEdge + e]];
+      candidates.insert(candidates.end(), childTop.begin(), childTop.end());
+    }
+
+    size_t keep = min(candidates.size(), MAX_TOP_K);
+    partial_sort(candidates.begin(), candidates.begin() + keep,
+                 candidates.end(), better);
+    candidates.resize(keep);
+    tops[i] = move(candidates);
+  }
+
+  for (size_t i = 0; i < order.size(); i++) {
+    trie->nodes[i].firstTop = trie->topTerms.size();
+    trie->nodes[i].topCount = tops[i].size();
+    trie->topTerms.insert(trie->topTerms.end(), tops[i].begin(),
+                          tops[i].end());
+  }
+
+  return trie;
+}
+
+// ============================================
+// COMPLETION TRIE - QUERIES
+// ============================================
+
+int CompletionTrie::findChild(uint32_t node, char label) const {
+  const Node &n = nodes[node];
+  auto begin = edgeLabels.begin() + n.firstEdge;
+  auto end = begin + n.edgeCount;
+  auto it = lower_bound(begin, end, label);
+  if (it == end || *it != label)
+    return -1;
+  return edgeTargets[it - edgeLabels.begin()];
+}
+
+vector<Completion> CompletionTrie::complete(const string &prefix,
+                                            size_t k) const {
+  vector<Completion> results;
+  if (nodes.empty())
+    return results;
+
+  uint32_t node = 0;
+  for (char ch : prefix) {
+    int child = findChild(node, tolower(static_cast<unsigned char>(ch)));
+    if (child < 0)
+      return results;
+    node = child;
+  }
+
+  const Node &n = nodes[node];
+  for (uint32_t i = 0; i < n.topCount && results.size() < k; i++)
+    results.push_back(terms[topTerms[n.firstTop + i]]);
+  return results;
+}
+
+// ============================================
+// AUTOCOMPLETE SERVICE - CONSTRUCTORS
+// ============================================
+
+AutocompleteService::AutocompleteService()
+    : current(CompletionTrie::build({})), hasPending(false), stopping(false),
+      rebuildCount(0) {
+  worker = thread(&AutocompleteService::workerLoop, this);
+}
+
+AutocompleteService::~AutocompleteService() {
+  {
+    lock_guard<mutex> lock(requestMutex);
+    stopping = true;
+  }
+  requestReady.notify_one();
+  if (worker.joinable())
+    worker.join();
+}
+
+// ============================================
+// AUTOCOMPLETE SERVICE - OPERATIONS
+// ============================================
+
+void AutocompleteService::requestRebuild(vector<Completion> terms) {
+  {
+    lock_guard<mutex> lock(requestMutex);
+    pendingTerms = move(terms);
+    hasPending = true;
+  }
+  requestReady.notify_one();
+}
+
+vector<Completion> AutocompleteService::complete(const string &prefix,
+                                                 size_t k) const {
+  shared_ptr<const CompletionTrie> trie = atomic_load(&current);
+  return trie->complete(prefix, k);
+}
+
+void AutocompleteService::workerLoop() {
+  while (true) {
+    vector<Completion> terms;
+    {
+      unique_lock<mutex> lock(requestMutex);
+      requestReady.wait(lock, [this] { return hasPending || stopping; });
+      if (stopping)
+        return;
+      terms = move(pendingTerms);
+      hasPending = false;
+    }
+
+    // Build outside the lock; readers keep using the old trie meanwhile
+    shared_ptr<const CompletionTrie> trie = CompletionTrie::build(move(terms));
+    atomic_store(&current, trie);
+
+    lock_guard<mutex> lock(requestMutex);
+    rebuildCount++;
+  }
+}
+
+// ============================================
+// AUTOCOMPLETE SERVICE - GETTERS
+// ============================================
+
+size_t AutocompleteService::getTermCount() const {
+  return atomic_load(&current)->termCount();
+}
+
+size_t AutocompleteService::getNodeCount() const {
+  return atomic_load(&current)->nodeCount();
+}
+
+uint64_t AutocompleteService::getRebuildCount() {
+  lock_guard<mutex> lock(requestMutex);
+  return rebuildCount;
+}
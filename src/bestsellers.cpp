@@ -0,0 +1,180 @@
+#include "../include/bestsellers.h"
+#include <algorithm>
+
+// ============================================
+// SPACE-SAVING SUMMARY
+// ============================================
+
+SpaceSavingSummary::SpaceSavingSummary(size_t capacity)
+    : capacity(max<size_t>(1, capacity)) {
+  heap.reserve(this->capacity);
+}
+
+void SpaceSavingSummary::place(size_t index, HeavyHitter counter) {
+  position[counter.productId] = index;
+  heap[index] = move(counter);
+}
+
+void SpaceSavingSummary::siftUp(size_t index) {
+  HeavyHitter moving = move(heap[index]);
+  while (index > 0) {
+    size_t parent = (index - 1) / 2;
+    if (heap[parent].units <= moving.units)
+      break;
+    place(index, move(heap[parent]));
+    index = parent;
+  }
+  place(index, move(moving));
+}
+
+void SpaceSavingSummary::siftDown(size_t index) {
+  HeavyHitter moving = move(heap[index]);
+  while (true) {
+    size_t child = 2 * index + 1;
+    if (child >= heap.size())
+      break;
+    if (child + 1 < heap.size() && heap[child + 1].units < heap[child].units)
+      child++;
+    if (moving.units <= heap[child].units)
+      break;
+    place(index, move(heap[child]));
+    index = child;
+  }
+  place(index, move(moving));
+}
+
+void SpaceSavingSummary::add(const string &productId, int64_t units) {
+  auto it = position.find(productId);
+  if (it != position.end()) {
+    size_t index = it->second;
+    heap[index].units += units;
+    siftDown(index); // Only ever grows, so it can only move down
+    return;
+  }
+
+  if (heap.size() < capacity) {
+    heap.push_back({productId, units, 0});
+    siftUp(heap.size() - 1);
+    return;
+  }
+
+  // Evict the smallest counter; the newcomer inherits its count
+  int64_t floor = heap.front().units;
+  position.erase(heap.front().productId);
+  heap.front() = {productId, floor + units, floor};
+  siftDown(0);
+}
+
+void SpaceSavingSummary::clear() {
+  heap.clear();
+  position.clear();
+}
+
+// ============================================
+// BEST SELLER TRACKER
+// ============================================
+
+BestSellerTracker::BestSellerTracker() {
+  const pair<int64_t, size_t> layout[] = {
+      {5 * 60, 12},     // LAST_HOUR
+      {60 * 60, 24},    // LAST_DAY
+      {24 * 60 * 60, 7} // LAST_WEEK
+  };
+  for (const auto &ring : layout) {
+    rings.push_back({ring.first,
+                     vector<SpaceSavingSummary>(
+                         ring.second,
+                         SpaceSavingSummary(COUNTERS_PER_BUCKET)),
+                     vector<int64_t>(ring.second, -1)});
+  }
+}
+
+void BestSellerTracker::record(const string &productId, int units,
+                               time_t soldAt) {
+  if (units <= 0)
+    return;
+  for (BucketRing &ring : rings) {
+    int64_t period = static_cast<int64_t>(soldAt) / ring.bucketSeconds;
+    size_t slot = period % ring.buckets.size();
+    int64_t start = period * ring.bucketSeconds;
+    if (ring.bucketStart[slot] != start) {
+      if (ring.bucketStart[slot] > start)
+        continue; // Older than anything the ring still covers
+      ring.buckets[slot].clear();
+      ring.bucketStart[slot] = start;
+    }
+    ring.buckets[slot].add(productId, units);
+  }
+}
+
+void BestSellerTracker::clear() {
+  for (BucketRing &ring : rings) {
+    for (SpaceSavingSummary &bucket : ring.buckets)
+      bucket.clear();
+    fill(ring.bucketStart.begin(), ring.bucketStart.end(), -1);
+  }
+}
+
+vector<HeavyHitter> BestSellerTracker::top(SalesWindow window, time_t now,
+                                           size_t limit) const {
+  const BucketRing &ring = rings[static_cast<size_t>(window)];
+  int64_t current = static_cast<int64_t>(now) / ring.bucketSeconds *
+                    ring.bucketSeconds;
+  int64_t oldest =
+      current - static_cast<int64_t>(ring.buckets.size() - 1) *
+                    ring.bucketSeconds;
+
+  // Sum the live buckets. A product missing from a full bucket may still
+  // have sold up to that bucket's floor there, so that goes into its error.
+  vector<const SpaceSavingSummary *> live;
+  for (size_t slot = 0; slot < ring.buckets.size(); slot++) {
+    if (ring.bucketStart[slot] >= oldest && ring.bucketStart[slot] <= current)
+      live.push_back(&ring.buckets[slot]);
+  }
+
+  unordered_map<string, HeavyHitter> merged;
+  for (const SpaceSavingSummary *bucket : live) {
+    for (const HeavyHitter &counter : bucket->getCounters()) {
+      HeavyHitter &total = merged[counter.productId];
+      total.productId = counter.productId;
+      total.units += counter.units;
+      total.error += counter.error;
+    }
+  }
+  for (const SpaceSavingSummary *bucket : live) {
+    if (!bucket->isFull())
+      continue;
+    for (auto &entry : merged) {
+      if (!bucket->contains(entry.first)) {
+        entry.second.units += bucket->getFloor();
+        entry.second.error += bucket->getFloor();
+      }
+    }
+  }
+
+  vector<HeavyHitter> result;
+  result.reserve(merged.size());
+  for (auto &entry : merged)
+    result.push_back(move(entry.second));
+  sort(result.begin(), result.end(),
+       [](const HeavyHitter &a, const HeavyHitter &b) {
+         return a.units != b.units ? a.units > b.units
+                                   : a.productId < b.productId;
+       });
+  if (result.size() > limit)
+    result.resize(limit);
+  return result;
+}
+
+string BestSellerTracker::windowToString(SalesWindow window) {
+  switch (window) {
+  case SalesWindow::LAST_HOUR:
+    return "Last hour";
+  case SalesWindow::LAST_DAY:
+    return "Last 24 hours";
+  case SalesWindow::LAST_WEEK:
+    return "Last 7 days";
+  default:
+    return "Last 7 days";
+  }
+}
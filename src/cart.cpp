@@ -1,8 +1,42 @@
 #include "../include/cart.h"
 #include "../include/exceptions.h"
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 
+// ============================================
+// ITEM LOOKUP
+// ============================================
+
+vector<CartItem>::iterator Cart::lowerBound(const string &productId) {
+  return lower_bound(items.begin(), items.end(), productId,
+                     [](const CartItem &item, const string &id) {
+                       return item.productId < id;
+                     });
+}
+
+vector<CartItem>::const_iterator
+Cart::lowerBound(const string &productId) const {
+  return lower_bound(items.begin(), items.end(), productId,
+                     [](const CartItem &item, const string &id) {
+                       return item.productId < id;
+                     });
+}
+
+bool Cart::hasProduct(const string &productId) const {
+  return findItem(productId) != nullptr;
+}
+
+CartItem *Cart::findItem(const string &productId) {
+  auto it = lowerBound(productId);
+  return it != items.end() && it->productId == productId ? &*it : nullptr;
+}
+
+const CartItem *Cart::findItem(const string &productId) const {
+  auto it = lowerBound(productId);
+  return it != items.end() && it->productId == productId ? &*it : nullptr;
+}
+
 // ============================================
 // CART OPERATIONS
 // ============================================
@@ -12,23 +46,24 @@ void Cart::addItem(const Product &product, int quantity) {
     throw InvalidInputException("Quantity must be positive");
   }
 
-  // Check if product already in cart
-  CartItem *existing = findItem(product.getId());
-  if (existing != nullptr) {
-    existing->quantity += quantity;
+  // Check if product already in cart; the line takes the current price
+  auto it = lowerBound(product.getId());
+  if (it != items.end() && it->productId == product.getId()) {
+    it->quantity += quantity;
+    it->price = product.getPrice();
   } else {
-    items.push_back(CartItem(product, quantity));
+    items.insert(it, CartItem(product.getId(), quantity, product.getPrice()));
   }
+  totalValid = false;
 }
 
 void Cart::removeItem(const string &productId) {
-  for (auto it = items.begin(); it != items.end(); ++it) {
-    if (it->product.getId() == productId) {
-      items.erase(it);
-      return;
-    }
+  auto it = lowerBound(productId);
+  if (it == items.end() || it->productId != productId) {
+    throw ProductNotFoundException("Product not found in cart: " + productId);
   }
-  throw ProductNotFoundException("Product not found in cart: " + productId);
+  items.erase(it);
+  totalValid = false;
 }
 
 void Cart::updateQuantity(const string &productId, int newQuantity) {
@@ -46,15 +81,79 @@ void Cart::updateQuantity(const string &productId, int newQuantity) {
     throw ProductNotFoundException("Product not found in cart: " + productId);
   }
   item->quantity = newQuantity;
+  totalValid = false;
+}
+
+void Cart::restoreItem(const CartItem &item) {
+  auto it = lowerBound(item.productId);
+  if (it != items.end() && it->productId == item.productId) {
+    it->quantity += item.quantity;
+  } else {
+    items.insert(it, item);
+  }
+  totalValid = false;
+}
+
+void Cart::clear() {
+  items.clear();
+  staleProducts.clear();
+  totalValid = false;
+}
+
+// ============================================
+// CHANGE PROPAGATION
+// ============================================
+
+void Cart::markStale(const string &productId) {
+  if (find(staleProducts.begin(), staleProducts.end(), productId) ==
+      staleProducts.end()) {
+    staleProducts.push_back(productId);
+  }
+  totalValid = false;
+}
+
+void Cart::markAllStale() {
+  staleProducts.clear();
+  for (const CartItem &item : items) {
+    staleProducts.push_back(item.productId);
+  }
+  totalValid = false;
 }
 
-void Cart::clear() { items.clear(); }
+vector<CartChange> Cart::refresh(const ProductLookup &lookup) {
+  vector<CartChange> changes;
+  for (const string &productId : staleProducts) {
+    auto it = lowerBound(productId);
+    if (it == items.end() || it->productId != productId)
+      continue; // Not in this cart (any more)
+
+    const Product *product = lookup(productId);
+    if (product == nullptr) {
+      changes.push_back(
+          {productId, CartChangeType::REMOVED, it->price, Money(), 0});
+      items.erase(it);
+      continue;
+    }
+    if (product->getPrice() != it->price) {
+      changes.push_back({productId, CartChangeType::PRICE_CHANGED, it->price,
+                         product->getPrice(), product->getQuantity()});
+      it->price = product->getPrice();
+    }
+    if (product->getQuantity() < it->quantity) {
+      changes.push_back({productId, CartChangeType::LOW_STOCK, it->price,
+                         it->price, product->getQuantity()});
+    }
+  }
+  staleProducts.clear();
+  totalValid = false;
+  return changes;
+}
 
 // ============================================
 // DISPLAY
 // ============================================
 
-void Cart::displayCart() const {
+void Cart::displayCart(const ProductLookup &lookup) const {
   if (items.empty()) {
     cout << endl;
     cout << Utils::colorText("┌─────────────────────────────────────────┐",
@@ -84,25 +183,26 @@ void Cart::displayCart() const {
        << endl;
 
   for (const CartItem &item : items) {
-    stringstream priceStr, subtotalStr;
-    priceStr << fixed << setprecision(2) << item.product.getPrice();
-    subtotalStr << fixed << setprecision(2) << item.getSubtotal();
+    string priceStr = item.price.toString();
+    string subtotalStr = item.getSubtotal().toString();
+    const Product *product = lookup(item.productId);
+    const string &name =
+        product != nullptr ? product->getName() : item.productId;
 
     cout << Utils::colorText("║", "yellow") << " "
-         << Utils::colorText(item.product.getId(), "yellow") << " | "
-         << Utils::colorText(item.product.getName(), "white", "", "bold");
+         << Utils::colorText(item.productId, "yellow") << " | "
+         << Utils::colorText(name, "white", "", "bold");
 
     // Padding for alignment
-    int nameLen = item.product.getName().length();
+    int nameLen = name.length();
     for (int i = nameLen; i < 25; i++)
       cout << " ";
 
-    cout << " x" << item.quantity << " @ $" << priceStr.str();
-    cout << " = "
-         << Utils::colorText("$" + subtotalStr.str(), "green", "", "bold");
+    cout << " x" << item.quantity << " @ $" << priceStr;
+    cout << " = " << Utils::colorText("$" + subtotalStr, "green", "", "bold");
 
     // Right padding
-    int totalLen = subtotalStr.str().length();
+    int totalLen = subtotalStr.length();
     for (int i = totalLen; i < 10; i++)
       cout << " ";
 
@@ -114,14 +214,13 @@ void Cart::displayCart() const {
                            "yellow")
        << endl;
 
-  stringstream totalStr;
-  totalStr << fixed << setprecision(2) << getTotal();
+  string totalStr = getTotal().toString();
 
   cout << Utils::colorText("║", "yellow")
        << "                                    "
-       << Utils::colorText("TOTAL: $" + totalStr.str(), "green", "", "bold");
+       << Utils::colorText("TOTAL: $" + totalStr, "green", "", "bold");
 
-  int totalLen = totalStr.str().length();
+  int totalLen = totalStr.length();
   for (int i = totalLen; i < 15; i++)
     cout << " ";
 
@@ -136,11 +235,22 @@ void Cart::displayCart() const {
 // GETTERS
 // ============================================
 
-double Cart::getTotal() const {
-  double total = 0.0;
-  for (const CartItem &item : items) {
-    total += item.getSubtotal();
+Money Cart::getTotal() const {
+  if (totalValid)
+    return cachedTotal;
+
+  // Sum in stack-sized batches so totalling a cart never allocates
+  int64_t subtotals[64];
+  Money total;
+  for (size_t start = 0; start < items.size(); start += 64) {
+    size_t count = min<size_t>(64, items.size() - start);
+    for (size_t i = 0; i < count; i++) {
+      subtotals[i] = items[start + i].getSubtotal().getCents();
+    }
+    total += Money::sum(subtotals, count);
   }
+  cachedTotal = total;
+  totalValid = true;
   return total;
 }
 
@@ -153,29 +263,3 @@ int Cart::getTotalQuantity() const {
   }
   return total;
 }
-
-// ============================================
-// ITEM LOOKUP
-// ============================================
-
-bool Cart::hasProduct(const string &productId) const {
-  return findItem(productId) != nullptr;
-}
-
-CartItem *Cart::findItem(const string &productId) {
-  for (auto &item : items) {
-    if (item.product.getId() == productId) {
-      return &item;
-    }
-  }
-  return nullptr;
-}
-
-const CartItem *Cart::findItem(const string &productId) const {
-  for (const auto &item : items) {
-    if (item.product.getId() == productId) {
-      return &item;
-    }
-  }
-  return nullptr;
-}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "../include/cartstore.h"
+#include "../include/exceptions.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+// ============================================
+// FILE PATHS
+// ============================================
+
+const string CartStore::CARTS_DIRECTORY = "data/carts";
+const string CartStore::FORMAT_HEADER = "MXC1";
+
+string CartStore::pathFor(int customerId) {
+  return CARTS_DIRECTORY + "/" + to_string(customerId) + ".cart";
+}
+
+// ============================================
+// STORAGE
+// ============================================
+
+void CartStore::ensureDirectory() {
+  error_code ec;
+  filesystem::create_directories(CARTS_DIRECTORY, ec);
+  if (ec) {
+    throw FileException("Cannot create " + CARTS_DIRECTORY + ": " +
+                        ec.message());
+  }
+}
+
+Cart CartStore::load(int customerId) {
+  Cart cart;
+  ifstream file(pathFor(customerId));
+  if (!file.is_open())
+    return cart; // Nothing saved yet
+
+  string line;
+  if (!getline(file, line) || line != FORMAT_HEADER) {
+    throw FileException("Unrecognised cart file for customer " +
+                        to_string(customerId));
+  }
+
+  while (getline(file, line)) {
+    istringstream fields(line);
+    string productId;
+    int quantity;
+    int64_t priceCents;
+    if (!(fields >> productId >> quantity >> priceCents) || quantity <= 0)
+      continue; // Skip damaged lines, keep the rest of the cart
+    cart.restoreItem(
+        CartItem(productId, quantity, Money::fromCents(priceCents)));
+  }
+  return cart;
+}
+
+void CartStore::save(int customerId, const Cart &cart) {
+  if (cart.isEmpty()) {
+    remove(customerId);
+    return;
+  }
+
+  string path = pathFor(customerId);
+  string tmpPath = path + ".tmp";
+  {
+    ofstream file(tmpPath);
+    if (!file.is_open()) {
+      throw FileException("Cannot write " + tmpPath);
+    }
+    file << FORMAT_HEADER << '\n';
+    for (const CartItem &item : cart.getItems()) {
+      file << item.productId << ' ' << item.quantity << ' '
+           << item.price.getCents() << '\n';
+    }
+    if (!file) {
+      throw FileException("Cannot write " + tmpPath);
+    }
+  }
+  if (rename(tmpPath.c_str(), path.c_str()) != 0) {
+    throw FileException("Cannot replace " + path);
+  }
+}
+
+void CartStore::remove(int customerId) {
+  std::remove(pathFor(customerId).c_str());
+}
+
+vector<int> CartStore::listCustomers() {
+  vector<int> customerIds;
+  error_code ec;
+  for (const auto &entry :
+       filesystem::directory_iterator(CARTS_DIRECTORY, ec)) {
+    if (entry.path().extension() != ".cart")
+      continue;
+    try {
+      customerIds.push_back(stoi(entry.path().stem().string()));
+    } catch (const exception &) {
+      // Not a customer cart file
+    }
+  }
+  return customerIds;
+}
@@ -0,0 +1,69 @@
+#include "../include/changefeed.h"
+#include <algorithm>
+
+// ============================================
+// SUBSCRIPTIONS
+// ============================================
+
+void ProductChangeFeed::subscribe(const string &productId, Cart *cart) {
+  vector<Cart *> &carts = subscribersByProduct[productId];
+  if (find(carts.begin(), carts.end(), cart) != carts.end())
+    return;
+  carts.push_back(cart);
+  productsByCart[cart].push_back(productId);
+}
+
+void ProductChangeFeed::unsubscribe(const string &productId, Cart *cart) {
+  auto byProduct = subscribersByProduct.find(productId);
+  if (byProduct != subscribersByProduct.end()) {
+    vector<Cart *> &carts = byProduct->second;
+    carts.erase(remove(carts.begin(), carts.end(), cart), carts.end());
+    if (carts.empty())
+      subscribersByProduct.erase(byProduct);
+  }
+
+  auto byCart = productsByCart.find(cart);
+  if (byCart != productsByCart.end()) {
+    vector<string> &productIds = byCart->second;
+    productIds.erase(remove(productIds.begin(), productIds.end(), productId),
+                     productIds.end());
+    if (productIds.empty())
+      productsByCart.erase(byCart);
+  }
+}
+
+void ProductChangeFeed::unsubscribeAll(Cart *cart) {
+  auto byCart = productsByCart.find(cart);
+  if (byCart == productsByCart.end())
+    return;
+
+  for (const string &productId : byCart->second) {
+    auto byProduct = subscribersByProduct.find(productId);
+    if (byProduct == subscribersByProduct.end())
+      continue;
+    vector<Cart *> &carts = byProduct->second;
+    carts.erase(remove(carts.begin(), carts.end(), cart), carts.end());
+    if (carts.empty())
+      subscribersByProduct.erase(byProduct);
+  }
+  productsByCart.erase(byCart);
+}
+
+size_t ProductChangeFeed::getSubscriberCount(const string &productId) const {
+  auto it = subscribersByProduct.find(productId);
+  return it == subscribersByProduct.end() ? 0 : it->second.size();
+}
+
+// ============================================
+// PUBLISHING
+// ============================================
+
+size_t ProductChangeFeed::publish(const string &productId) {
+  auto it = subscribersByProduct.find(productId);
+  if (it == subscribersByProduct.end())
+    return 0;
+  for (Cart *cart : it->second) {
+    cart->markStale(productId);
+  }
+  return it->second.size();
+}
@@ -1,5 +1,4 @@
 #include "../include/customer.h"
-#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -22,13 +21,8 @@ void Customer::displayMenu() {
   Utils::showSubHeader("Customer Menu");
 
   cout << Utils::colorText("  1. ", "yellow") << "Browse Products" << endl;
-  cout << Utils::colorText("  2. ", "yellow") << "View Cart"
-       << Utils::colorText(" [" + to_string(cartProductIds.size()) + " items]",
-                           "yellow")
-       << endl;
-  cout << Utils::colorText("  3. ", "yellow") << "Place Order" << endl;
-  cout << Utils::colorText("  4. ", "yellow") << "Order History" << endl;
-  cout << Utils::colorText("  5. ", "yellow") << "My Profile" << endl;
+  cout << Utils::colorText("  2. ", "yellow") << "Order History" << endl;
+  cout << Utils::colorText("  3. ", "yellow") << "My Profile" << endl;
   cout << Utils::colorText("  0. ", "red") << "Logout" << endl;
   cout << endl;
 }
@@ -50,15 +44,11 @@ void Customer::displayInfo() const {
        << endl;
   cout << "  Phone:   "
        << Utils::colorText(phone.empty() ? "Not set" : phone, "white") << endl;
-  cout << "  Cart:    "
-       << Utils::colorText(to_string(cartProductIds.size()) + " items",
-                           "yellow")
-       << endl;
   cout << Utils::colorText("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━", "green") << endl;
 }
 
 // ============================================
-// CART OPERATIONS
+// CUSTOMER FEATURES
 // ============================================
 
 void Customer::browseProducts() {
@@ -68,59 +58,6 @@ void Customer::browseProducts() {
        << endl;
 }
 
-void Customer::addToCart(int productId) {
-  cartProductIds.push_back(productId);
-  cout << Utils::colorText("✓ Product added to cart!", "green") << endl;
-}
-
-void Customer::removeFromCart(int productId) {
-  auto it = find(cartProductIds.begin(), cartProductIds.end(), productId);
-  if (it != cartProductIds.end()) {
-    cartProductIds.erase(it);
-    cout << Utils::colorText("✓ Product removed from cart!", "green") << endl;
-  } else {
-    cout << Utils::colorText("✗ Product not found in cart!", "red") << endl;
-  }
-}
-
-void Customer::viewCart() const {
-  Utils::showSubHeader("Your Shopping Cart");
-
-  if (cartProductIds.empty()) {
-    cout << Utils::colorText("   Your cart is empty 🛒", "yellow") << endl;
-  } else {
-    cout << "   Items in cart: "
-         << Utils::colorText(to_string(cartProductIds.size()), "green", "",
-                             "bold")
-         << endl;
-    // TODO: Display actual product details when Product class is ready
-    for (size_t i = 0; i < cartProductIds.size(); i++) {
-      cout << "   " << (i + 1) << ". Product ID: " << cartProductIds[i] << endl;
-    }
-  }
-  cout << endl;
-}
-
-void Customer::clearCart() {
-  cartProductIds.clear();
-  cout << Utils::colorText("✓ Cart cleared!", "green") << endl;
-}
-
-void Customer::placeOrder() {
-  if (cartProductIds.empty()) {
-    cout << Utils::colorText("✗ Cannot place order - cart is empty!", "red")
-         << endl;
-    return;
-  }
-
-  // TODO: Will create actual Order when Order class is ready
-  cout << Utils::colorText("🎉 Order placed successfully!", "green", "", "bold")
-       << endl;
-  cout << Utils::colorText("   Thank you for shopping with MerxQ!", "yellow")
-       << endl;
-  clearCart();
-}
-
 void Customer::viewOrderHistory() const {
   Utils::showSubHeader("Order History");
 
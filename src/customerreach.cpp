@@ -0,0 +1,238 @@
+#include "../include/customerreach.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+// ============================================
+// HYPERLOGLOG SKETCH
+// ============================================
+
+HyperLogLog::HyperLogLog(uint8_t precision)
+    : precision(min<uint8_t>(16, max<uint8_t>(4, precision))) {}
+
+void HyperLogLog::raise(size_t index, uint8_t rank) {
+  if (!isSparse()) {
+    if (rank > registers[index])
+      registers[index] = rank;
+    return;
+  }
+
+  uint32_t entry = static_cast<uint32_t>(index) << 8 | rank;
+  auto it = lower_bound(sparse.begin(), sparse.end(),
+                        static_cast<uint32_t>(index) << 8);
+  if (it != sparse.end() && (*it >> 8) == index) {
+    *it = max(*it, entry);
+    return;
+  }
+  sparse.insert(it, entry);
+  if (sparse.size() * sizeof(uint32_t) >= registerCount())
+    toDense();
+}
+
+void HyperLogLog::toDense() {
+  registers.assign(registerCount(), 0);
+  for (uint32_t entry : sparse)
+    registers[entry >> 8] = entry & 0xFF;
+  sparse.clear();
+  sparse.shrink_to_fit();
+}
+
+void HyperLogLog::add(uint64_t value) {
+  // Top bits pick the register; the rest give the rank of the first set
+  // bit. The low guard bit keeps the rank bounded when the rest is zero.
+  size_t index = value >> (64 - precision);
+  uint64_t rest = (value << precision) | (uint64_t(1) << (precision - 1));
+  raise(index, __builtin_clzll(rest) + 1);
+}
+
+void HyperLogLog::merge(const HyperLogLog &other) {
+  if (other.precision != precision)
+    return; // Sketches of different sizes cannot be combined
+  if (other.isSparse()) {
+    for (uint32_t entry : other.sparse)
+      raise(entry >> 8, entry & 0xFF);
+    return;
+  }
+  if (isSparse())
+    toDense();
+  for (size_t i = 0; i < registers.size(); i++)
+    registers[i] = max(registers[i], other.registers[i]);
+}
+
+double HyperLogLog::estimate() const {
+  double m = registerCount();
+  double sum = 0;
+  size_t zeros = 0;
+  if (isSparse()) {
+    // Registers missing from the list are zero
+    zeros = registerCount() - sparse.size();
+    sum = zeros;
+    for (uint32_t entry : sparse)
+      sum += ldexp(1.0, -static_cast<int>(entry & 0xFF));
+  } else {
+    for (uint8_t reg : registers) {
+      sum += ldexp(1.0, -reg);
+      if (reg == 0)
+        zeros++;
+    }
+  }
+  double alpha = 0.7213 / (1 + 1.079 / m);
+  double raw = alpha * m * m / sum;
+  if (raw <= 2.5 * m && zeros > 0)
+    return m * log(m / zeros); // Linear counting for small cardinalities
+  return raw;
+}
+
+double HyperLogLog::getStandardError() const {
+  return 1.04 / sqrt(static_cast<double>(registerCount()));
+}
+
+// ============================================
+// MAINTENANCE
+// ============================================
+
+// splitmix64 finaliser - spreads sequential IDs over all 64 bits
+uint64_t CustomerReach::hashCustomer(int customerId) {
+  uint64_t x = static_cast<uint64_t>(customerId) + 0x9E3779B97F4A7C15ull;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+void CustomerReach::addOrder(const Order &order, const ProductLookup &lookup,
+                             map<string, SketchMap> &products,
+                             map<string, SketchMap> &categories) {
+  string month = Utils::formatTimestamp(order.getCreatedAt()).substr(0, 7);
+  uint64_t customer = hashCustomer(order.getCustomerId());
+  SketchMap &monthProducts = products[month];
+  SketchMap &monthCategories = categories[month];
+
+  for (const OrderItem &item : order.getItems()) {
+    string category = item.category;
+    if (category.empty()) {
+      const Product *product = lookup(item.productId);
+      category = product != nullptr ? product->getCategory() : "Uncategorized";
+    }
+    monthProducts[item.productId].add(customer);
+    monthCategories[category].add(customer);
+  }
+}
+
+void CustomerReach::mergeInto(map<string, SketchMap> &target,
+                              const map<string, SketchMap> &source) {
+  for (const auto &month : source) {
+    SketchMap &targetMonth = target[month.first];
+    for (const auto &sketch : month.second) {
+      auto it = targetMonth.find(sketch.first);
+      if (it == targetMonth.end()) {
+        targetMonth.emplace(sketch.first, sketch.second);
+      } else {
+        it->second.merge(sketch.second);
+      }
+    }
+  }
+}
+
+void CustomerReach::build(const vector<Order> &orders,
+                          const ProductLookup &lookup, unsigned threads) {
+  if (threads == 0)
+    threads = max(1u, thread::hardware_concurrency());
+  threads = min<unsigned>(threads, max<size_t>(1, orders.size()));
+
+  // Each worker sketches its own slice of orders; the partials are then
+  // merged, which gives the same registers as one sequential pass
+  vector<map<string, SketchMap>> partialProducts(threads);
+  vector<map<string, SketchMap>> partialCategories(threads);
+  auto work = [&](unsigned t, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      if (orders[i].getStatus() != OrderStatus::CANCELLED)
+        addOrder(orders[i], lookup, partialProducts[t], partialCategories[t]);
+    }
+  };
+
+  size_t slice = (orders.size() + threads - 1) / threads;
+  vector<thread> workers;
+  for (unsigned t = 1; t < threads; t++) {
+    size_t begin = t * slice;
+    size_t end = min(orders.size(), begin + slice);
+    if (begin < end)
+      workers.emplace_back(work, t, begin, end);
+  }
+  work(0, 0, min(orders.size(), slice));
+  for (thread &worker : workers)
+    worker.join();
+
+  productsByMonth = move(partialProducts[0]);
+  categoriesByMonth = move(partialCategories[0]);
+  for (unsigned t = 1; t < threads; t++) {
+    mergeInto(productsByMonth, partialProducts[t]);
+    mergeInto(categoriesByMonth, partialCategories[t]);
+  }
+}
+
+void CustomerReach::orderPlaced(const Order &order,
+                                const ProductLookup &lookup) {
+  addOrder(order, lookup, productsByMonth, categoriesByMonth);
+}
+
+// ============================================
+// QUERIES
+// ============================================
+
+vector<ReachRow> CustomerReach::rank(const map<string, SketchMap> &byMonth,
+                                     const string &fromMonth, size_t limit) {
+  // Union of the monthly sketches in range, per key
+  SketchMap merged;
+  for (auto month = byMonth.lower_bound(fromMonth); month != byMonth.end();
+       ++month) {
+    for (const auto &sketch : month->second) {
+      auto it = merged.find(sketch.first);
+      if (it == merged.end()) {
+        merged.emplace(sketch.first, sketch.second);
+      } else {
+        it->second.merge(sketch.second);
+      }
+    }
+  }
+
+  vector<ReachRow> rows;
+  rows.reserve(merged.size());
+  for (const auto &sketch : merged)
+    rows.push_back({sketch.first, sketch.second.estimate()});
+  sort(rows.begin(), rows.end(), [](const ReachRow &a, const ReachRow &b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  });
+  if (rows.size() > limit)
+    rows.resize(limit);
+  return rows;
+}
+
+vector<ReachRow> CustomerReach::topProducts(const string &fromMonth,
+                                            size_t limit) const {
+  return rank(productsByMonth, fromMonth, limit);
+}
+
+vector<ReachRow> CustomerReach::topCategories(const string &fromMonth,
+                                              size_t limit) const {
+  return rank(categoriesByMonth, fromMonth, limit);
+}
+
+size_t CustomerReach::getSketchCount() const {
+  size_t count = 0;
+  for (const auto &month : productsByMonth)
+    count += month.second.size();
+  for (const auto &month : categoriesByMonth)
+    count += month.second.size();
+  return count;
+}
+
+size_t CustomerReach::memoryBytes() const {
+  size_t bytes = 0;
+  for (const auto &month : productsByMonth)
+    for (const auto &sketch : month.second)
+      bytes += sketch.second.memoryBytes();
+  for (const auto &month : categoriesByMonth)
+    for (const auto &sketch : month.second)
+      bytes += sketch.second.memoryBytes();
+  return bytes;
+}
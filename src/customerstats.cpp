@@ -0,0 +1,222 @@
+#include "../include/customerstats.h"
+#include "../include/exceptions.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+// ============================================
+// FILE PATHS
+// ============================================
+
+const string CustomerStats::STATS_FILE = "data/customer_stats.bin";
+const char CustomerStats::FORMAT_HEADER[4] = {'M', 'X', 'S', '1'};
+
+// Fixed on-disk record layout (native byte order)
+struct StatsRecord {
+  int32_t orders;
+  int32_t cancelled;
+  int64_t spendCents;
+  int64_t lastOrderAt;
+};
+static_assert(sizeof(StatsRecord) == 24, "customer stats records are 24 bytes");
+
+// ============================================
+// CONSTRUCTORS
+// ============================================
+
+CustomerStats::CustomerStats() : orderCount(0), cancelledCount(0) {}
+
+// ============================================
+// MAINTENANCE
+// ============================================
+
+CustomerTotals &CustomerStats::totalsFor(int customerId) {
+  size_t index = max(0, customerId);
+  if (index >= byCustomer.size())
+    byCustomer.resize(index + 1);
+  return byCustomer[index];
+}
+
+static void addOrder(CustomerTotals &totals, const Order &order) {
+  totals.orders++;
+  totals.lastOrderAt = max(totals.lastOrderAt, order.getCreatedAt());
+  if (order.getStatus() == OrderStatus::CANCELLED) {
+    totals.cancelled++;
+  } else {
+    totals.spendCents += order.getTotalAmount().getCents();
+  }
+}
+
+void CustomerStats::rebuild(const vector<Order> &orders, unsigned threads) {
+  int maxCustomer = 0;
+  for (const Order &order : orders)
+    maxCustomer = max(maxCustomer, order.getCustomerId());
+
+  if (threads == 0)
+    threads = max(1u, thread::hardware_concurrency());
+  threads = min<unsigned>(threads, max<size_t>(1, orders.size()));
+
+  // Every worker fills its own ID-indexed table from its slice of orders
+  vector<vector<CustomerTotals>> partials(
+      threads, vector<CustomerTotals>(maxCustomer + 1));
+  vector<size_t> partialCancelled(threads, 0);
+  auto work = [&](unsigned t, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      const Order &order = orders[i];
+      addOrder(partials[t][max(0, order.getCustomerId())], order);
+      if (order.getStatus() == OrderStatus::CANCELLED)
+        partialCancelled[t]++;
+    }
+  };
+
+  size_t slice = (orders.size() + threads - 1) / threads;
+  vector<thread> workers;
+  for (unsigned t = 1; t < threads; t++) {
+    size_t begin = t * slice;
+    size_t end = min(orders.size(), begin + slice);
+    if (begin < end)
+      workers.emplace_back(work, t, begin, end);
+  }
+  work(0, 0, min(orders.size(), slice));
+  for (thread &worker : workers)
+    worker.join();
+
+  byCustomer = move(partials[0]);
+  cancelledCount = partialCancelled[0];
+  for (unsigned t = 1; t < threads; t++) {
+    for (size_t id = 0; id < byCustomer.size(); id++) {
+      CustomerTotals &total = byCustomer[id];
+      const CustomerTotals &part = partials[t][id];
+      total.orders += part.orders;
+      total.cancelled += part.cancelled;
+      total.spendCents += part.spendCents;
+      total.lastOrderAt = max(total.lastOrderAt, part.lastOrderAt);
+    }
+    cancelledCount += partialCancelled[t];
+  }
+  orderCount = orders.size();
+}
+
+void CustomerStats::orderPlaced(const Order &order) {
+  addOrder(totalsFor(order.getCustomerId()), order);
+  orderCount++;
+}
+
+void CustomerStats::orderCancelled(const Order &order) {
+  CustomerTotals &totals = totalsFor(order.getCustomerId());
+  totals.cancelled++;
+  totals.spendCents -= order.getTotalAmount().getCents();
+  cancelledCount++;
+}
+
+bool CustomerStats::matches(size_t orders, size_t cancelled) const {
+  return orderCount == orders && cancelledCount == cancelled;
+}
+
+// ============================================
+// STORAGE
+// ============================================
+
+static StatsRecord toRecord(const CustomerTotals &totals) {
+  return {totals.orders, totals.cancelled, totals.spendCents,
+          totals.lastOrderAt};
+}
+
+static void writeHeader(ostream &file, const char format[4],
+                        uint64_t orders, uint64_t cancelled) {
+  file.write(format, 4);
+  file.write(reinterpret_cast<const char *>(&orders), sizeof(orders));
+  file.write(reinterpret_cast<const char *>(&cancelled), sizeof(cancelled));
+}
+
+void CustomerStats::load() {
+  byCustomer.clear();
+  orderCount = 0;
+  cancelledCount = 0;
+
+  ifstream file(STATS_FILE, ios::binary);
+  if (!file.is_open())
+    return; // Nothing saved yet
+
+  char format[4];
+  uint64_t orders, cancelled;
+  file.read(format, 4);
+  file.read(reinterpret_cast<char *>(&orders), sizeof(orders));
+  file.read(reinterpret_cast<char *>(&cancelled), sizeof(cancelled));
+  if (!file || memcmp(format, FORMAT_HEADER, 4) != 0) {
+    throw FileException("Unrecognised " + STATS_FILE);
+  }
+
+  StatsRecord record;
+  while (file.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+    byCustomer.push_back({record.orders, record.cancelled, record.spendCents,
+                          record.lastOrderAt});
+  }
+  orderCount = orders;
+  cancelledCount = cancelled;
+}
+
+void CustomerStats::save() const {
+  string tmpPath = STATS_FILE + ".tmp";
+  {
+    ofstream file(tmpPath, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+      throw FileException("Cannot write " + tmpPath);
+    }
+    writeHeader(file, FORMAT_HEADER, orderCount, cancelledCount);
+    for (const CustomerTotals &totals : byCustomer) {
+      StatsRecord record = toRecord(totals);
+      file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    }
+    if (!file) {
+      throw FileException("Cannot write " + tmpPath);
+    }
+  }
+  if (rename(tmpPath.c_str(), STATS_FILE.c_str()) != 0) {
+    throw FileException("Cannot replace " + STATS_FILE);
+  }
+}
+
+void CustomerStats::persist(int customerId) const {
+  fstream file(STATS_FILE, ios::binary | ios::in | ios::out);
+  if (!file.is_open()) {
+    save(); // No file yet - write all of it
+    return;
+  }
+  writeHeader(file, FORMAT_HEADER, orderCount, cancelledCount);
+
+  // Records before this one that the file does not have yet are written
+  // too, so the file never has gaps
+  file.seekp(0, ios::end);
+  streamoff length = file.tellp();
+  if (length < static_cast<streamoff>(HEADER_BYTES)) {
+    file.close();
+    save();
+    return;
+  }
+  size_t saved = (length - HEADER_BYTES) / sizeof(StatsRecord);
+  size_t from = min(saved, static_cast<size_t>(max(0, customerId)));
+  file.seekp(HEADER_BYTES + from * sizeof(StatsRecord));
+  for (size_t id = from; id <= static_cast<size_t>(max(0, customerId)) &&
+                         id < byCustomer.size();
+       id++) {
+    StatsRecord record = toRecord(byCustomer[id]);
+    file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+  }
+  if (!file) {
+    throw FileException("Cannot write " + STATS_FILE);
+  }
+}
+
+// ============================================
+// QUERIES
+// ============================================
+
+const CustomerTotals &CustomerStats::get(int customerId) const {
+  static const CustomerTotals none;
+  if (customerId < 0 || static_cast<size_t>(customerId) >= byCustomer.size())
+    return none;
+  return byCustomer[customerId];
+}
@@ -0,0 +1,525 @@
+#include "../include/facetindex.h"
+#include <algorithm>
+
+// ============================================
+// ROARING BITMAP - CONTAINERS
+// ============================================
+
+bool RoaringBitmap::Container::contains(uint16_t low) const {
+  if (isBitset()) {
+    return (bits[low >> 6] >> (low & 63)) & 1ULL;
+  }
+  return binary_search(array.begin(), array.end(), low);
+}
+
+bool RoaringBitmap::Container::add(uint16_t low) {
+  if (isBitset()) {
+    uint64_t mask = 1ULL << (low & 63);
+    if (bits[low >> 6] & mask)
+      return false;
+    bits[low >> 6] |= mask;
+    cardinality++;
+    return true;
+  }
+
+  auto it = lower_bound(array.begin(), array.end(), low);
+  if (it != array.end() && *it == low)
+    return false;
+  array.insert(it, low);
+  cardinality++;
+  if (cardinality > ARRAY_LIMIT)
+    toBitset();
+  return true;
+}
+
+bool RoaringBitmap::Container::remove(uint16_t low) {
+  if (isBitset()) {
+    uint64_t mask = 1ULL << (low & 63);
+    if (!(bits[low >> 6] & mask))
+      return false;
+    bits[low >> 6] &= ~mask;
+    cardinality--;
+    if (cardinality <= ARRAY_LIMIT)
+      toArray();
+    return true;
+  }
+
+  auto it = lower_bound(array.begin(), array.end(), low);
+  if (it == array.end() || *it != low)
+    return false;
+  array.erase(it);
+  cardinality--;
+  return true;
+}
+
+void RoaringBitmap::Container::toBitset() {
+  bits.assign(BITSET_WORDS, 0);
+  for (uint16_t low : array)
+    bits[low >> 6] |= 1ULL << (low & 63);
+  array.clear();
+  array.shrink_to_fit();
+}
+
+void RoaringBitmap::Container::toArray() {
+  array.clear();
+  array.reserve(cardinality);
+  for (size_t w = 0; w < BITSET_WORDS; w++) {
+    uint64_t word = bits[w];
+    while (word) {
+      int bit = __builtin_ctzll(word);
+      array.push_back(static_cast<uint16_t>(w * 64 + bit));
+      word &= word - 1;
+    }
+  }
+  bits.clear();
+  bits.shrink_to_fit();
+}
+
+RoaringBitmap::Container *RoaringBitmap::findContainer(uint16_t key) {
+  auto it = lower_bound(
+      containers.begin(), containers.end(), key,
+      [](const Container &c, uint16_t k) { return c.key < k; });
+  if (it != containers.end() && it->key == key)
+    return &*it;
+  return nullptr;
+}
+
+const RoaringBitmap::Container *
+RoaringBitmap::findContainer(uint16_t key) const {
+  auto it = lower_bound(
+      containers.begin(), containers.end(), key,
+      [](const Container &c, uint16_t k) { return c.key < k; });
+  if (it != containers.end() && it->key == key)
+    return &*it;
+  return nullptr;
+}
+
+RoaringBitmap::Container RoaringBitmap::andContainers(const Container &a,
+                                                      const Container &b) {
+  Container result;
+  result.key = a.key;
+
+  if (a.isBitset() && b.isBitset()) {
+    result.bits.assign(BITSET_WORDS, 0);
+    for (size_t w = 0; w < BITSET_WORDS; w++) {
+      result.bits[w] = a.bits[w] & b.bits[w];
+      result.cardinality += __builtin_popcountll(result.bits[w]);
+    }
+    if (result.cardinality <= ARRAY_LIMIT)
+      result.toArray();
+    return result;
+  }
+
+  if (a.isBitset() || b.isBitset()) {
+    const Container &sparse = a.isBitset() ? b : a;
+    const Container &dense = a.isBitset() ? a : b;
+    for (uint16_t low : sparse.array) {
+      if (dense.contains(low))
+        result.array.push_back(low);
+    }
+  } else {
+    set_intersection(a.array.begin(), a.array.end(), b.array.begin(),
+                     b.array.end(), back_inserter(result.array));
+  }
+  result.cardinality = result.array.size();
+  return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::orContainers(const Container &a,
+                                                     const Container &b) {
+  Container result;
+  result.key = a.key;
+
+  if (!a.isBitset() && !b.isBitset() &&
+      a.cardinality + b.cardinality <= ARRAY_LIMIT) {
+    set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+              back_inserter(result.array));
+    result.cardinality = result.array.size();
+    return result;
+  }
+
+  result.bits.assign(BITSET_WORDS, 0);
+  for (const Container *c : {&a, &b}) {
+    if (c->isBitset()) {
+      for (size_t w = 0; w < BITSET_WORDS; w++)
+        result.bits[w] |= c->bits[w];
+    } else {
+      for (uint16_t low : c->array)
+        result.bits[low >> 6] |= 1ULL << (low & 63);
+    }
+  }
+  for (uint64_t word : result.bits)
+    result.cardinality += __builtin_popcountll(word);
+  if (result.cardinality <= ARRAY_LIMIT)
+    result.toArray();
+  return result;
+}
+
+// ============================================
+// ROARING BITMAP - MUTATION
+// ============================================
+
+void RoaringBitmap::add(uint32_t value) {
+  uint16_t key = value >> 16;
+  Container *c = findContainer(key);
+  if (c == nullptr) {
+    auto it = lower_bound(
+        containers.begin(), containers.end(), key,
+        [](const Container &ct, uint16_t k) { return ct.key < k; });
+    it = containers.insert(it, Container());
+    it->key = key;
+    c = &*it;
+  }
+  c->add(value & 0xFFFF);
+}
+
+void RoaringBitmap::remove(uint32_t value) {
+  Container *c = findContainer(value >> 16);
+  if (c == nullptr)
+    return;
+  c->remove(value & 0xFFFF);
+  if (c->cardinality == 0)
+    containers.erase(containers.begin() + (c - containers.data()));
+}
+
+// ============================================
+// ROARING BITMAP - QUERIES
+// ============================================
+
+bool RoaringBitmap::contains(uint32_t value) const {
+  const Container *c = findContainer(value >> 16);
+  return c != nullptr && c->contains(value & 0xFFFF);
+}
+
+size_t RoaringBitmap::cardinality() const {
+  size_t total = 0;
+  for (const Container &c : containers)
+    total += c.cardinality;
+  return total;
+}
+
+vector<uint32_t> RoaringBitmap::toVector() const {
+  vector<uint32_t> values;
+  values.reserve(cardinality());
+  for (const Container &c : containers) {
+    uint32_t high = static_cast<uint32_t>(c.key) << 16;
+    if (c.isBitset()) {
+      for (size_t w = 0; w < BITSET_WORDS; w++) {
+        uint64_t word = c.bits[w];
+        while (word) {
+          values.push_back(high | (w * 64 + __builtin_ctzll(word)));
+          word &= word - 1;
+        }
+      }
+    } else {
+      for (uint16_t low : c.array)
+        values.push_back(high | low);
+    }
+  }
+  return values;
+}
+
+bool RoaringBitmap::previous(uint32_t below, uint32_t &value) const {
+  if (below == 0)
+    return false;
+  uint32_t target = below - 1;
+  uint16_t targetKey = target >> 16;
+
+  // Last container whose key is not past the target, then walk back
+  auto it = upper_bound(
+      containers.begin(), containers.end(), targetKey,
+      [](uint16_t key, const Container &c) { return key < c.key; });
+  while (it != containers.begin()) {
+    --it;
+    const Container &c = *it;
+    uint16_t highest = c.key == targetKey ? target & 0xFFFF : 0xFFFF;
+    uint32_t high = static_cast<uint32_t>(c.key) << 16;
+    if (c.isBitset()) {
+      size_t w = highest / 64;
+      size_t bit = highest % 64;
+      uint64_t word = c.bits[w] & (bit == 63 ? ~0ULL : (1ULL << (bit + 1)) - 1);
+      while (true) {
+        if (word) {
+          value = high | (w * 64 + 63 - __builtin_clzll(word));
+          return true;
+        }
+        if (w == 0)
+          break;
+        word = c.bits[--w];
+      }
+    } else {
+      auto pos = upper_bound(c.array.begin(), c.array.end(), highest);
+      if (pos != c.array.begin()) {
+        value = high | *(pos - 1);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// ============================================
+// ROARING BITMAP - SET OPERATIONS
+// ============================================
+
+RoaringBitmap RoaringBitmap::operator&(const RoaringBitmap &other) const {
+  RoaringBitmap result;
+  size_t i = 0, j = 0;
+  while (i < containers.size() && j < other.containers.size()) {
+    if (containers[i].key < other.containers[j].key) {
+      i++;
+    } else if (containers[i].key > other.containers[j].key) {
+      j++;
+    } else {
+      Container c = andContainers(containers[i], other.containers[j]);
+      if (c.cardinality > 0)
+        result.containers.push_back(move(c));
+      i++;
+      j++;
+    }
+  }
+  return result;
+}
+
+RoaringBitmap RoaringBitmap::operator|(const RoaringBitmap &other) const {
+  RoaringBitmap result;
+  size_t i = 0, j = 0;
+  while (i < containers.size() || j < other.containers.size()) {
+    if (j == other.containers.size() ||
+        (i < containers.size() &&
+         containers[i].key < other.containers[j].key)) {
+      result.containers.push_back(containers[i++]);
+    } else if (i == containers.size() ||
+               other.containers[j].key < containers[i].key) {
+      result.containers.push_back(other.containers[j++]);
+    } else {
+      result.containers.push_back(
+          orContainers(containers[i++], other.containers[j++]));
+    }
+  }
+  return result;
+}
+
+// ============================================
+// FACET INDEX - CONSTRUCTOR
+// ============================================
+
+FacetIndex::FacetIndex(int lowStockThreshold)
+    : byPriceBand(priceBandCount()), byStockState(3),
+      lowStockThreshold(lowStockThreshold) {}
+
+// ============================================
+// FACET INDEX - MAINTENANCE
+// ============================================
+
+void FacetIndex::rebuild(const vector<Product> &products) {
+  slotByProductId.clear();
+  productIdBySlot.clear();
+  slotFacets.clear();
+  freeSlots.clear();
+  allProducts.clear();
+  byCategory.clear();
+  for (RoaringBitmap &b : byPriceBand)
+    b.clear();
+  for (RoaringBitmap &b : byStockState)
+    b.clear();
+
+  for (const Product &p : products) {
+    upsert(p);
+  }
+}
+
+void FacetIndex::upsert(const Product &product) {
+  uint32_t slot;
+  auto it = slotByProductId.find(product.getId());
+
+  if (it != slotByProductId.end()) {
+    slot = it->second;
+    unindexSlot(slot);
+  } else if (!freeSlots.empty()) {
+    slot = freeSlots.back();
+    freeSlots.pop_back();
+    slotByProductId[product.getId()] = slot;
+    productIdBySlot[slot] = product.getId();
+  } else {
+    slot = productIdBySlot.size();
+    slotByProductId[product.getId()] = slot;
+    productIdBySlot.push_back(product.getId());
+    slotFacets.push_back(SlotFacets());
+  }
+
+  SlotFacets &facets = slotFacets[slot];
+  facets.category = product.getCategory();
+  facets.priceBand = priceBandOf(product.getPrice());
+  facets.stockState = stockStateOf(product.getQuantity());
+  facets.live = true;
+
+  allProducts.add(slot);
+  byCategory[facets.category].add(slot);
+  byPriceBand[facets.priceBand].add(slot);
+  byStockState[static_cast<int>(facets.stockState)].add(slot);
+}
+
+void FacetIndex::setLowStockThreshold(int threshold,
+                                     const vector<Product> &products) {
+  lowStockThreshold = threshold;
+  rebuild(products);
+}
+
+void FacetIndex::remove(const string &productId) {
+  auto it = slotByProductId.find(productId);
+  if (it == slotByProductId.end())
+    return;
+
+  uint32_t slot = it->second;
+  unindexSlot(slot);
+  slotFacets[slot].live = false;
+  productIdBySlot[slot].clear();
+  slotByProductId.erase(it);
+  freeSlots.push_back(slot);
+}
+
+void FacetIndex::unindexSlot(uint32_t slot) {
+  SlotFacets &facets = slotFacets[slot];
+  if (!facets.live)
+    return;
+
+  allProducts.remove(slot);
+
+  auto cat = byCategory.find(facets.category);
+  if (cat != byCategory.end()) {
+    cat->second.remove(slot);
+    if (cat->second.isEmpty())
+      byCategory.erase(cat);
+  }
+  byPriceBand[facets.priceBand].remove(slot);
+  byStockState[static_cast<int>(facets.stockState)].remove(slot);
+  facets.live = false;
+}
+
+// ============================================
+// FACET INDEX - QUERIES
+// ============================================
+
+RoaringBitmap
+FacetIndex::categoryFilter(const vector<string> &categories) const {
+  if (categories.empty())
+    return allProducts;
+
+  RoaringBitmap result;
+  for (const string &category : categories) {
+    auto it = byCategory.find(category);
+    if (it != byCategory.end())
+      result = result | it->second;
+  }
+  return result;
+}
+
+RoaringBitmap FacetIndex::priceBandFilter(const vector<int> &priceBands) const {
+  if (priceBands.empty())
+    return allProducts;
+
+  RoaringBitmap result;
+  for (int band : priceBands) {
+    if (band >= 0 && band < priceBandCount())
+      result = result | byPriceBand[band];
+  }
+  return result;
+}
+
+RoaringBitmap
+FacetIndex::stockStateFilter(const vector<StockState> &states) const {
+  if (states.empty())
+    return allProducts;
+
+  RoaringBitmap result;
+  for (StockState state : states)
+    result = result | byStockState[static_cast<int>(state)];
+  return result;
+}
+
+FacetResult FacetIndex::query(const FacetQuery &facetQuery) const {
+  RoaringBitmap categoryMatch = categoryFilter(facetQuery.categories);
+  RoaringBitmap priceMatch = priceBandFilter(facetQuery.priceBands);
+  RoaringBitmap stockMatch = stockStateFilter(facetQuery.stockStates);
+
+  FacetResult result;
+  for (uint32_t slot : (categoryMatch & priceMatch & stockMatch).toVector())
+    result.productIds.push_back(productIdBySlot[slot]);
+
+  // Each facet is counted against the other two filters, so the counts
+  // show how many results selecting that value would add or keep
+  RoaringBitmap withoutCategory = priceMatch & stockMatch;
+  for (const auto &entry : byCategory)
+    result.categoryCounts[entry.first] =
+        (withoutCategory & entry.second).cardinality();
+
+  RoaringBitmap withoutPrice = categoryMatch & stockMatch;
+  for (const RoaringBitmap &band : byPriceBand)
+    result.priceBandCounts.push_back((withoutPrice & band).cardinality());
+
+  RoaringBitmap withoutStock = categoryMatch & priceMatch;
+  for (const RoaringBitmap &state : byStockState)
+    result.stockStateCounts.push_back((withoutStock & state).cardinality());
+
+  return result;
+}
+
+vector<string> FacetIndex::getCategories() const {
+  vector<string> categories;
+  for (const auto &entry : byCategory)
+    categories.push_back(entry.first);
+  return categories;
+}
+
+// ============================================
+// FACET INDEX - FACET VALUES
+// ============================================
+
+int FacetIndex::priceBandCount() { return 4; }
+
+int FacetIndex::priceBandOf(Money price) {
+  if (price < Money::fromCents(100 * 100))
+    return 0;
+  if (price < Money::fromCents(500 * 100))
+    return 1;
+  if (price < Money::fromCents(1000 * 100))
+    return 2;
+  return 3;
+}
+
+string FacetIndex::priceBandLabel(int band) {
+  switch (band) {
+  case 0:
+    return "Under $100";
+  case 1:
+    return "$100 - $499.99";
+  case 2:
+    return "$500 - $999.99";
+  case 3:
+    return "$1000 and above";
+  default:
+    return "Unknown";
+  }
+}
+
+StockState FacetIndex::stockStateOf(int quantity) const {
+  if (quantity <= 0)
+    return StockState::OUT_OF_STOCK;
+  if (quantity < lowStockThreshold)
+    return StockState::LOW_STOCK;
+  return StockState::IN_STOCK;
+}
+
+string FacetIndex::stockStateLabel(StockState state) {
+  switch (state) {
+  case StockState::IN_STOCK:
+    return "In Stock";
+  case StockState::LOW_STOCK:
+    return "Low Stock";
+  case StockState::OUT_OF_STOCK:
+    return "Out of Stock";
+  default:
+    return "Unknown";
+  }
+}
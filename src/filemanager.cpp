@@ -7,6 +7,43 @@
 
 using json = nlohmann::ordered_json;
 
+// ============================================
+// MONEY <-> JSON
+// ============================================
+// Amounts are written as decimal numbers (1299.99) so the files stay
+// readable; the shortest round-trip form of cents / 100 always reads
+// back to the same cent value. String amounts are accepted as well.
+
+static json moneyToJson(const Money &amount) { return amount.toDouble(); }
+
+static Money moneyFromJson(const json &item, const string &key) {
+  if (!item.contains(key))
+    return Money();
+  const json &value = item[key];
+  if (value.is_string())
+    return Money::parse(value.get<string>());
+  if (value.is_number())
+    return Money::fromDouble(value.get<double>());
+  return Money();
+}
+
+// ============================================
+// TIMESTAMPS <-> JSON
+// ============================================
+// Timestamps are stored as epoch seconds. Files written before that used
+// "YYYY-MM-DD HH:MM:SS" local-time strings, which are still accepted.
+
+static int64_t timestampFromJson(const json &item, const string &key) {
+  if (!item.contains(key))
+    return 0;
+  const json &value = item[key];
+  if (value.is_number_integer())
+    return value.get<int64_t>();
+  if (value.is_string())
+    return max<int64_t>(0, Utils::parseTimestamp(value.get<string>()));
+  return 0;
+}
+
 // ============================================
 // FILE PATHS
 // ============================================
@@ -14,6 +51,11 @@ using json = nlohmann::ordered_json;
 const string FileManager::PRODUCTS_FILE = "data/products.json";
 const string FileManager::USERS_FILE = "data/users.json";
 const string FileManager::ORDERS_FILE = "data/orders.json";
+const string FileManager::SETTINGS_FILE = "data/settings.json";
+const string FileManager::WAREHOUSES_FILE = "data/warehouses.json";
+const string FileManager::WAREHOUSE_STOCK_FILE = "data/warehouse_stock.json";
+const string FileManager::PROMOTIONS_FILE = "data/promotions.json";
+const string FileManager::SALES_ROLLUPS_FILE = "data/sales_rollups.json";
 
 // ============================================
 // UTILITY
@@ -63,7 +105,7 @@ vector<Product> FileManager::loadProducts() {
     for (const auto &item : j) {
       Product p(item.value("id", ""), item.value("name", ""),
                 item.value("category", ""), item.value("description", ""),
-                item.value("price", 0.0), item.value("quantity", 0));
+                moneyFromJson(item, "price"), item.value("quantity", 0));
       products.push_back(p);
     }
   } catch (const exception &e) {
@@ -81,7 +123,7 @@ void FileManager::saveProducts(const vector<Product> &products) {
                    {"name", p.getName()},
                    {"category", p.getCategory()},
                    {"description", p.getDescription()},
-                   {"price", p.getPrice()},
+                   {"price", moneyToJson(p.getPrice())},
                    {"quantity", p.getQuantity()}});
     }
 
@@ -317,19 +359,28 @@ vector<Order> FileManager::loadOrders() {
           OrderItem oi;
           oi.productId = orderItem.value("productId", "");
           oi.productName = orderItem.value("productName", "");
-          oi.price = orderItem.value("price", 0.0);
+          oi.category = orderItem.value("category", "");
+          oi.price = moneyFromJson(orderItem, "price");
           oi.quantity = orderItem.value("quantity", 0);
           orderItems.push_back(oi);
         }
       }
 
-      Order order(item.value("id", ""), item.value("customerId", 0), orderItems,
-                  item.value("totalAmount", 0.0));
-
-      string statusStr = item.value("status", "Pending");
-      order.updateStatus(Order::stringToStatus(statusStr));
+      // Restored as stored: status and both timestamps are kept exactly
+      int64_t createdAt = timestampFromJson(item, "createdAt");
+      int64_t updatedAt = timestampFromJson(item, "updatedAt");
+      Order order = Order::restore(
+          item.value("id", ""), item.value("customerId", 0),
+          move(orderItems), moneyFromJson(item, "totalAmount"),
+          Order::stringToStatus(item.value("status", "Pending")), createdAt,
+          updatedAt == 0 ? createdAt : updatedAt);
+
+      Money discount = moneyFromJson(item, "discountAmount");
+      if (discount > Money()) {
+        order.setDiscount(discount, item.value("couponCode", ""));
+      }
 
-      orders.push_back(order);
+      orders.push_back(move(order));
     }
   } catch (const exception &e) {
     throw FileException("Error loading orders: " + string(e.what()));
@@ -345,19 +396,27 @@ void FileManager::saveOrders(const vector<Order> &orders) {
     for (const Order &order : orders) {
       json itemsJson = json::array();
       for (const OrderItem &item : order.getItems()) {
-        itemsJson.push_back({{"productId", item.productId},
-                             {"productName", item.productName},
-                             {"price", item.price},
-                             {"quantity", item.quantity}});
+        json itemJson = {{"productId", item.productId},
+                         {"productName", item.productName},
+                         {"price", moneyToJson(item.price)},
+                         {"quantity", item.quantity}};
+        if (!item.category.empty())
+          itemJson["category"] = item.category;
+        itemsJson.push_back(itemJson);
       }
 
-      j.push_back({{"id", order.getId()},
-                   {"customerId", order.getCustomerId()},
-                   {"items", itemsJson},
-                   {"totalAmount", order.getTotalAmount()},
-                   {"status", order.getStatusString()},
-                   {"createdAt", order.getCreatedAt()},
-                   {"updatedAt", order.getUpdatedAt()}});
+      json orderJson = {{"id", order.getId()},
+                        {"customerId", order.getCustomerId()},
+                        {"items", itemsJson},
+                        {"totalAmount", moneyToJson(order.getTotalAmount())},
+                        {"status", order.getStatusString()},
+                        {"createdAt", order.getCreatedAt()},
+                        {"updatedAt", order.getUpdatedAt()}};
+      if (order.getDiscountAmount() > Money()) {
+        orderJson["discountAmount"] = moneyToJson(order.getDiscountAmount());
+        orderJson["couponCode"] = order.getCouponCode();
+      }
+      j.push_back(orderJson);
     }
 
     ofstream file(ORDERS_FILE);
@@ -392,25 +451,6 @@ void FileManager::addOrder(const Order &order) {
   saveOrders(orders);
 }
 
-void FileManager::updateOrderStatus(const string &orderId, OrderStatus status) {
-  vector<Order> orders = loadOrders();
-  bool found = false;
-
-  for (auto &order : orders) {
-    if (order.getId() == orderId) {
-      order.updateStatus(status);
-      found = true;
-      break;
-    }
-  }
-
-  if (!found) {
-    throw MerxQException("Order not found: " + orderId);
-  }
-
-  saveOrders(orders);
-}
-
 string FileManager::generateOrderId() {
   vector<Order> orders = loadOrders();
   int maxId = 0;
@@ -430,3 +470,332 @@ string FileManager::generateOrderId() {
   ss << "ORD" << setfill('0') << setw(4) << (maxId + 1);
   return ss.str();
 }
+
+// ============================================
+// SETTINGS
+// ============================================
+
+StoreSettings FileManager::loadSettings() {
+  StoreSettings settings;
+
+  try {
+    ifstream file(SETTINGS_FILE);
+    if (!file.is_open()) {
+      return settings; // Defaults until an admin saves settings
+    }
+
+    json j;
+    file >> j;
+    file.close();
+
+    settings.cartHoldsEnabled =
+        j.value("cartHoldsEnabled", settings.cartHoldsEnabled);
+    settings.cartHoldTtlSeconds =
+        j.value("cartHoldTtlSeconds", settings.cartHoldTtlSeconds);
+    if (j.contains("flashSaleProductIds")) {
+      settings.flashSaleProductIds =
+          j["flashSaleProductIds"].get<vector<string>>();
+    }
+    settings.flashSaleRatePerSecond =
+        j.value("flashSaleRatePerSecond", settings.flashSaleRatePerSecond);
+    settings.flashSaleBurst =
+        j.value("flashSaleBurst", settings.flashSaleBurst);
+    settings.lowStockThreshold =
+        j.value("lowStockThreshold", settings.lowStockThreshold);
+  } catch (const exception &e) {
+    throw FileException("Error loading settings: " + string(e.what()));
+  }
+
+  return settings;
+}
+
+void FileManager::saveSettings(const StoreSettings &settings) {
+  try {
+    json j = {{"cartHoldsEnabled", settings.cartHoldsEnabled},
+              {"cartHoldTtlSeconds", settings.cartHoldTtlSeconds},
+              {"flashSaleProductIds", settings.flashSaleProductIds},
+              {"flashSaleRatePerSecond", settings.flashSaleRatePerSecond},
+              {"flashSaleBurst", settings.flashSaleBurst},
+              {"lowStockThreshold", settings.lowStockThreshold}};
+
+    ofstream file(SETTINGS_FILE);
+    if (!file.is_open()) {
+      throw FileException("Cannot open settings file for writing");
+    }
+    file << setw(4) << j << endl;
+    file.close();
+  } catch (const FileException &) {
+    throw;
+  } catch (const exception &e) {
+    throw FileException("Error saving settings: " + string(e.what()));
+  }
+}
+
+// ============================================
+// WAREHOUSES
+// ============================================
+
+vector<Warehouse> FileManager::loadWarehouses() {
+  vector<Warehouse> warehouses;
+
+  try {
+    ifstream file(WAREHOUSES_FILE);
+    if (file.is_open()) {
+      json j;
+      file >> j;
+      file.close();
+
+      for (const auto &item : j) {
+        Warehouse w;
+        w.id = item["id"];
+        w.name = item.value("name", w.id);
+        w.region = item.value("region", "");
+        warehouses.push_back(w);
+      }
+    }
+  } catch (const exception &e) {
+    throw FileException("Error loading warehouses: " + string(e.what()));
+  }
+
+  // A store without a warehouse list ships everything from one place
+  if (warehouses.empty()) {
+    warehouses.push_back({"MAIN", "Main Warehouse", ""});
+  }
+  return warehouses;
+}
+
+void FileManager::saveWarehouses(const vector<Warehouse> &warehouses) {
+  try {
+    json j = json::array();
+    for (const Warehouse &w : warehouses) {
+      j.push_back({{"id", w.id}, {"name", w.name}, {"region", w.region}});
+    }
+
+    ofstream file(WAREHOUSES_FILE);
+    if (!file.is_open()) {
+      throw FileException("Cannot open warehouses file for writing");
+    }
+    file << setw(4) << j << endl;
+    file.close();
+  } catch (const FileException &) {
+    throw;
+  } catch (const exception &e) {
+    throw FileException("Error saving warehouses: " + string(e.what()));
+  }
+}
+
+WarehouseStockMap FileManager::loadWarehouseStock() {
+  WarehouseStockMap stock;
+
+  try {
+    ifstream file(WAREHOUSE_STOCK_FILE);
+    if (!file.is_open()) {
+      return stock; // Seeded from product quantities on first run
+    }
+
+    json j;
+    file >> j;
+    file.close();
+
+    for (auto &product : j.items()) {
+      for (auto &location : product.value().items()) {
+        stock[product.key()][location.key()] = location.value().get<int>();
+      }
+    }
+  } catch (const exception &e) {
+    throw FileException("Error loading warehouse stock: " + string(e.what()));
+  }
+
+  return stock;
+}
+
+void FileManager::saveWarehouseStock(const WarehouseStockMap &stock) {
+  try {
+    json j = json::object();
+    for (const auto &product : stock) {
+      j[product.first] = json::object();
+      for (const auto &location : product.second) {
+        j[product.first][location.first] = location.second;
+      }
+    }
+
+    ofstream file(WAREHOUSE_STOCK_FILE);
+    if (!file.is_open()) {
+      throw FileException("Cannot open warehouse stock file for writing");
+    }
+    file << setw(4) << j << endl;
+    file.close();
+  } catch (const FileException &) {
+    throw;
+  } catch (const exception &e) {
+    throw FileException("Error saving warehouse stock: " + string(e.what()));
+  }
+}
+
+// ============================================
+// PROMOTIONS
+// ============================================
+
+vector<PromotionRule> FileManager::loadPromotions() {
+  vector<PromotionRule> rules;
+
+  try {
+    ifstream file(PROMOTIONS_FILE);
+    if (!file.is_open()) {
+      return rules; // No promotions configured
+    }
+
+    json j;
+    file >> j;
+    file.close();
+
+    for (const auto &item : j) {
+      PromotionRule rule;
+      rule.id = item.value("id", "");
+      rule.type = PromotionEngine::stringToType(
+          item.value("type", "CATEGORY_DISCOUNT"));
+      rule.description = item.value("description", "");
+      rule.active = item.value("active", true);
+      rule.productId = item.value("productId", "");
+      rule.category = item.value("category", "");
+      rule.percent = item.value("percent", 0);
+      rule.buyQuantity = item.value("buyQuantity", 0);
+      rule.freeQuantity = item.value("freeQuantity", 0);
+      if (item.contains("tiers")) {
+        for (const auto &tier : item["tiers"]) {
+          rule.tiers.push_back(
+              {tier.value("minQuantity", 0), tier.value("percent", 0)});
+        }
+      }
+      rule.couponCode = item.value("couponCode", "");
+      rule.amountOff = moneyFromJson(item, "amountOff");
+      rule.minSubtotal = moneyFromJson(item, "minSubtotal");
+      rules.push_back(rule);
+    }
+  } catch (const exception &e) {
+    throw FileException("Error loading promotions: " + string(e.what()));
+  }
+
+  return rules;
+}
+
+void FileManager::savePromotions(const vector<PromotionRule> &rules) {
+  try {
+    json j = json::array();
+    for (const PromotionRule &rule : rules) {
+      json item = {{"id", rule.id},
+                   {"type", PromotionEngine::typeToString(rule.type)},
+                   {"description", rule.description},
+                   {"active", rule.active}};
+      if (!rule.productId.empty())
+        item["productId"] = rule.productId;
+      if (!rule.category.empty())
+        item["category"] = rule.category;
+      if (rule.percent != 0)
+        item["percent"] = rule.percent;
+      if (rule.type == PromotionType::BUY_X_GET_Y) {
+        item["buyQuantity"] = rule.buyQuantity;
+        item["freeQuantity"] = rule.freeQuantity;
+      }
+      if (!rule.tiers.empty()) {
+        json tiers = json::array();
+        for (const PriceTier &tier : rule.tiers) {
+          tiers.push_back(
+              {{"minQuantity", tier.minQuantity}, {"percent", tier.percent}});
+        }
+        item["tiers"] = tiers;
+      }
+      if (rule.type == PromotionType::COUPON) {
+        item["couponCode"] = rule.couponCode;
+        item["amountOff"] = moneyToJson(rule.amountOff);
+        item["minSubtotal"] = moneyToJson(rule.minSubtotal);
+      }
+      j.push_back(item);
+    }
+
+    ofstream file(PROMOTIONS_FILE);
+    if (!file.is_open()) {
+      throw FileException("Cannot open promotions file for writing");
+    }
+    file << setw(4) << j << endl;
+    file.close();
+  } catch (const FileException &) {
+    throw;
+  } catch (const exception &e) {
+    throw FileException("Error saving promotions: " + string(e.what()));
+  }
+}
+
+// ============================================
+// SALES ROLLUPS
+// ============================================
+
+static json rollupRowsToJson(const map<string, RollupRow> &rows) {
+  json j = json::object();
+  for (const auto &row : rows) {
+    j[row.first] = {{"revenue", moneyToJson(row.second.revenue)},
+                    {"units", row.second.units},
+                    {"orders", row.second.orders}};
+  }
+  return j;
+}
+
+static map<string, RollupRow> rollupRowsFromJson(const json &j,
+                                                 const string &key) {
+  map<string, RollupRow> rows;
+  if (!j.contains(key))
+    return rows;
+  for (auto &entry : j[key].items()) {
+    RollupRow &row = rows[entry.key()];
+    row.revenue = moneyFromJson(entry.value(), "revenue");
+    row.units = entry.value().value("units", static_cast<int64_t>(0));
+    row.orders = entry.value().value("orders", static_cast<int64_t>(0));
+  }
+  return rows;
+}
+
+SalesRollupTables FileManager::loadSalesRollups() {
+  SalesRollupTables tables;
+
+  try {
+    ifstream file(SALES_ROLLUPS_FILE);
+    if (!file.is_open()) {
+      return tables; // Built from the orders on first run
+    }
+
+    json j;
+    file >> j;
+    file.close();
+
+    tables.orderCount = j.value("orderCount", static_cast<size_t>(0));
+    tables.cancelledCount = j.value("cancelledCount", static_cast<size_t>(0));
+    tables.days = rollupRowsFromJson(j, "days");
+    tables.products = rollupRowsFromJson(j, "products");
+    tables.categories = rollupRowsFromJson(j, "categories");
+  } catch (const exception &e) {
+    throw FileException("Error loading sales rollups: " + string(e.what()));
+  }
+
+  return tables;
+}
+
+void FileManager::saveSalesRollups(const SalesRollupTables &tables) {
+  try {
+    json j = {{"orderCount", tables.orderCount},
+              {"cancelledCount", tables.cancelledCount},
+              {"days", rollupRowsToJson(tables.days)},
+              {"products", rollupRowsToJson(tables.products)},
+              {"categories", rollupRowsToJson(tables.categories)}};
+
+    ofstream file(SALES_ROLLUPS_FILE);
+    if (!file.is_open()) {
+      throw FileException("Cannot open sales rollups file for writing");
+    }
+    file << setw(4) << j << endl;
+    file.close();
+  } catch (const FileException &) {
+    throw;
+  } catch (const exception &e) {
+    throw FileException("Error saving sales rollups: " + string(e.what()));
+  }
+}
@@ -0,0 +1,195 @@
+#include "../include/flashsale.h"
+#include <chrono>
+#include <thread>
+
+// ============================================
+// FLASH SALE POOL - CONSTRUCTORS
+// ============================================
+
+FlashSalePool::FlashSalePool(size_t poolCount) : poolCount(poolCount) {
+  if (this->poolCount == 0)
+    this->poolCount = thread::hardware_concurrency();
+  if (this->poolCount == 0)
+    this->poolCount = 1;
+  pools.reset(new SubPool[this->poolCount]);
+}
+
+// ============================================
+// FLASH SALE POOL - INTERNALS
+// ============================================
+
+size_t FlashSalePool::homePool() const {
+  // Threads are numbered round-robin the first time they ask
+  static atomic<size_t> nextThread{0};
+  thread_local size_t threadIndex = nextThread.fetch_add(1);
+  return threadIndex % poolCount;
+}
+
+bool FlashSalePool::takeFrom(size_t pool, int quantity) {
+  atomic<int> &units = pools[pool].units;
+  int current = units.load(memory_order_relaxed);
+  while (current >= quantity) {
+    if (units.compare_exchange_weak(current, current - quantity,
+                                    memory_order_acq_rel,
+                                    memory_order_relaxed))
+      return true;
+  }
+  return false;
+}
+
+bool FlashSalePool::stealInto(size_t home, int quantity) {
+  // Move half of the first non-empty sub-pool (at least what is needed)
+  // into the home pool
+  for (size_t i = 1; i < poolCount; i++) {
+    atomic<int> &victim = pools[(home + i) % poolCount].units;
+    int current = victim.load(memory_order_relaxed);
+    while (current > 0) {
+      int grab = (current + 1) / 2;
+      if (grab < quantity)
+        grab = current < quantity ? current : quantity;
+      if (victim.compare_exchange_weak(current, current - grab,
+                                       memory_order_acq_rel,
+                                       memory_order_relaxed)) {
+        pools[home].units.fetch_add(grab, memory_order_acq_rel);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// ============================================
+// FLASH SALE POOL - STOCK
+// ============================================
+
+bool FlashSalePool::take(int quantity) {
+  size_t home = homePool();
+
+  // Fast path, then rebalance a few times while other pools have stock
+  for (size_t attempt = 0; attempt <= poolCount; attempt++) {
+    if (takeFrom(home, quantity)) {
+      pools[home].reserved.fetch_add(quantity, memory_order_relaxed);
+      return true;
+    }
+    if (!stealInto(home, quantity))
+      break;
+  }
+
+  // Slow path: the units may be spread thinly - gather them piecewise
+  int gathered = 0;
+  for (size_t i = 0; i < poolCount && gathered < quantity; i++) {
+    atomic<int> &units = pools[(home + i) % poolCount].units;
+    int current = units.load(memory_order_relaxed);
+    while (current > 0 && gathered < quantity) {
+      int grab = current < quantity - gathered ? current : quantity - gathered;
+      if (units.compare_exchange_weak(current, current - grab,
+                                      memory_order_acq_rel,
+                                      memory_order_relaxed))
+        gathered += grab;
+    }
+  }
+  if (gathered == quantity) {
+    pools[home].reserved.fetch_add(quantity, memory_order_relaxed);
+    return true;
+  }
+
+  give(gathered);
+  return false;
+}
+
+void FlashSalePool::commit(int quantity) {
+  pools[homePool()].reserved.fetch_sub(quantity, memory_order_relaxed);
+}
+
+void FlashSalePool::release(int quantity) {
+  size_t home = homePool();
+  pools[home].reserved.fetch_sub(quantity, memory_order_relaxed);
+  pools[home].units.fetch_add(quantity, memory_order_acq_rel);
+}
+
+void FlashSalePool::give(int quantity) {
+  if (quantity > 0)
+    pools[homePool()].units.fetch_add(quantity, memory_order_acq_rel);
+}
+
+void FlashSalePool::distribute(int quantity) {
+  int share = quantity / static_cast<int>(poolCount);
+  int extra = quantity % static_cast<int>(poolCount);
+  for (size_t i = 0; i < poolCount; i++) {
+    int units = share + (static_cast<int>(i) < extra ? 1 : 0);
+    if (units > 0)
+      pools[i].units.fetch_add(units, memory_order_acq_rel);
+  }
+}
+
+int FlashSalePool::drain() {
+  int total = 0;
+  for (size_t i = 0; i < poolCount; i++)
+    total += pools[i].units.exchange(0, memory_order_acq_rel);
+  return total;
+}
+
+// ============================================
+// FLASH SALE POOL - GETTERS
+// ============================================
+
+int FlashSalePool::total() const {
+  int total = 0;
+  for (size_t i = 0; i < poolCount; i++)
+    total += pools[i].units.load(memory_order_relaxed);
+  return total;
+}
+
+int FlashSalePool::reservedTotal() const {
+  int total = 0;
+  for (size_t i = 0; i < poolCount; i++)
+    total += pools[i].reserved.load(memory_order_relaxed);
+  return total;
+}
+
+// ============================================
+// TOKEN BUCKET
+// ============================================
+
+TokenBucket::TokenBucket(int ratePerSecond, int burst)
+    : theoreticalArrival(0), interval(0), burstTolerance(0), admitted(0),
+      rejected(0) {
+  configure(ratePerSecond, burst);
+}
+
+void TokenBucket::configure(int ratePerSecond, int burst) {
+  if (ratePerSecond < 1)
+    ratePerSecond = 1;
+  if (burst < 1)
+    burst = 1;
+  int64_t perToken = 1000000000LL / ratePerSecond;
+  interval.store(perToken);
+  burstTolerance.store(perToken * (burst - 1));
+}
+
+int64_t TokenBucket::nowNanos() {
+  return chrono::duration_cast<chrono::nanoseconds>(
+             chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+bool TokenBucket::tryAdmit() {
+  int64_t now = nowNanos();
+  int64_t step = interval.load(memory_order_relaxed);
+  int64_t tolerance = burstTolerance.load(memory_order_relaxed);
+  int64_t tat = theoreticalArrival.load(memory_order_relaxed);
+
+  while (true) {
+    int64_t start = tat > now ? tat : now;
+    if (start - now > tolerance) {
+      rejected.fetch_add(1, memory_order_relaxed);
+      return false;
+    }
+    if (theoreticalArrival.compare_exchange_weak(tat, start + step,
+                                                 memory_order_acq_rel,
+                                                 memory_order_relaxed)) {
+      admitted.fetch_add(1, memory_order_relaxed);
+      return true;
+    }
+  }
+}
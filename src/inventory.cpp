@@ -0,0 +1,371 @@
+#include "../include/inventory.h"
+#include "../include/exceptions.h"
+#include <functional>
+#include <thread>
+
+// ============================================
+// CONSTRUCTORS
+// ============================================
+
+InventoryEngine::InventoryEngine() : slotCount(0), registry(nullptr) {
+  registryVersions.emplace_back(new Registry());
+  registry.store(registryVersions.back().get());
+}
+
+// ============================================
+// SLOTS
+// ============================================
+
+InventoryEngine::StockCounter &InventoryEngine::counter(int slot) const {
+  return chunks[slot / CHUNK_SIZE][slot % CHUNK_SIZE];
+}
+
+int InventoryEngine::registerSlots(const vector<string> &productIds) {
+  const Registry *current = registry.load(memory_order_acquire);
+  unique_ptr<Registry> next;
+  int lastSlot = -1;
+
+  for (const string &id : productIds) {
+    auto it = current->find(id);
+    if (it != current->end()) {
+      lastSlot = it->second;
+      continue;
+    }
+    if (!next)
+      next.reset(new Registry(*current));
+    if (next->count(id)) {
+      lastSlot = next->at(id);
+      continue;
+    }
+
+    size_t slot = slotCount.load();
+    if (slot >= CHUNK_SIZE * MAX_CHUNKS) {
+      throw MerxQException("Inventory engine is full");
+    }
+    if (!chunks[slot / CHUNK_SIZE]) {
+      chunks[slot / CHUNK_SIZE].reset(new StockCounter[CHUNK_SIZE]);
+    }
+    (*next)[id] = slot;
+    slotCount.store(slot + 1);
+    lastSlot = slot;
+  }
+
+  // One copy of the map per batch, published after the counters exist
+  if (next) {
+    registry.store(next.get());
+    registryVersions.push_back(move(next));
+    reclaimRegistries();
+  }
+  return lastSlot;
+}
+
+// A reader that loaded an old snapshot is counted in some stripe until it
+// is done. All stripes at zero after the new snapshot was published means
+// every later reader will load the new one, so the old ones can go. If a
+// reader is busy they simply wait for the next publish.
+void InventoryEngine::reclaimRegistries() {
+  if (registryVersions.size() <= 1)
+    return;
+  for (const ReaderStripe &stripe : readers) {
+    if (stripe.active.load() != 0)
+      return;
+  }
+  registryVersions.erase(registryVersions.begin(), registryVersions.end() - 1);
+}
+
+size_t InventoryEngine::readerStripe() {
+  thread_local size_t stripe =
+      hash<thread::id>()(this_thread::get_id()) % READER_STRIPES;
+  return stripe;
+}
+
+int InventoryEngine::slotOf(const string &productId) const {
+  // Sequentially consistent on both sides: either the writer sees this
+  // reader's mark, or this reader sees the newest snapshot
+  atomic<int> &active = readers[readerStripe()].active;
+  active.fetch_add(1);
+  const Registry *current = registry.load();
+  auto it = current->find(productId);
+  int slot = it == current->end() ? -1 : it->second;
+  active.fetch_sub(1);
+  return slot;
+}
+
+InventoryEngine::FlashSale *
+InventoryEngine::activeFlashSale(const StockCounter &c) const {
+  FlashSale *flash = c.flashSale.load(memory_order_acquire);
+  if (flash == nullptr || !flash->active.load(memory_order_acquire))
+    return nullptr;
+  return flash;
+}
+
+// ============================================
+// CATALOG SYNC
+// ============================================
+
+void InventoryEngine::load(const vector<Product> &products) {
+  lock_guard<mutex> lock(writerMutex);
+
+  vector<string> ids;
+  ids.reserve(products.size());
+  for (const Product &p : products)
+    ids.push_back(p.getId());
+  registerSlots(ids);
+
+  // Existing slots are kept (their chunks stay valid); only the counts
+  // are reset to what the catalog says is on hand
+  const Registry *current = registry.load();
+  for (const auto &entry : *current) {
+    StockCounter &c = counter(entry.second);
+    FlashSale *flash = c.flashSale.load();
+    if (flash != nullptr) {
+      flash->active.store(false);
+      flash->pool.drain();
+    }
+    c.available.store(0);
+    c.reserved.store(0);
+  }
+  for (const Product &p : products) {
+    counter(slotOf(p.getId())).available.store(p.getQuantity());
+  }
+}
+
+void InventoryEngine::setOnHand(const string &productId, int quantity) {
+  int slot = slotOf(productId);
+  if (slot < 0) {
+    lock_guard<mutex> lock(writerMutex);
+    slot = registerSlots({productId});
+  }
+
+  // Units already reserved stay reserved; the rest becomes available
+  StockCounter &c = counter(slot);
+  FlashSale *flash = activeFlashSale(c);
+  if (flash != nullptr) {
+    int target = quantity - getReserved(productId);
+    flash->pool.drain();
+    flash->pool.distribute(target < 0 ? 0 : target);
+    return;
+  }
+
+  int current = c.available.load();
+  int target;
+  do {
+    target = quantity - getReserved(productId);
+    if (target < 0)
+      target = 0;
+  } while (!c.available.compare_exchange_weak(current, target));
+}
+
+void InventoryEngine::removeProduct(const string &productId) {
+  int slot = slotOf(productId);
+  if (slot < 0)
+    return;
+  endFlashSale(productId);
+  counter(slot).available.store(0);
+}
+
+// ============================================
+// FLASH SALES
+// ============================================
+
+void InventoryEngine::startFlashSale(const string &productId,
+                                     int ratePerSecond, int burst) {
+  int slot = slotOf(productId);
+  if (slot < 0) {
+    throw ProductNotFoundException("Product not found: " + productId);
+  }
+  StockCounter &c = counter(slot);
+
+  FlashSale *flash = c.flashSale.load();
+  if (flash == nullptr) {
+    lock_guard<mutex> lock(writerMutex);
+    flash = c.flashSale.load();
+    if (flash == nullptr) {
+      flashSales.emplace_back(new FlashSale(ratePerSecond, burst));
+      flash = flashSales.back().get();
+      c.flashSale.store(flash);
+    }
+  }
+  flash->gate.configure(ratePerSecond, burst);
+  if (flash->active.exchange(true))
+    return;
+
+  // New reservations go to the pool from here on; move the remaining
+  // single-counter stock into it
+  flash->pool.distribute(c.available.exchange(0));
+}
+
+void InventoryEngine::endFlashSale(const string &productId) {
+  int slot = slotOf(productId);
+  if (slot < 0)
+    return;
+  StockCounter &c = counter(slot);
+  FlashSale *flash = c.flashSale.load();
+  if (flash != nullptr && flash->active.exchange(false)) {
+    c.available.fetch_add(flash->pool.drain());
+  }
+}
+
+bool InventoryEngine::isFlashSale(const string &productId) const {
+  int slot = slotOf(productId);
+  return slot >= 0 && activeFlashSale(counter(slot)) != nullptr;
+}
+
+bool InventoryEngine::admit(const string &productId) {
+  int slot = slotOf(productId);
+  if (slot < 0)
+    return true;
+  FlashSale *flash = activeFlashSale(counter(slot));
+  return flash == nullptr || flash->gate.tryAdmit();
+}
+
+FlashSaleStats
+InventoryEngine::getFlashSaleStats(const string &productId) const {
+  FlashSaleStats stats;
+  int slot = slotOf(productId);
+  if (slot < 0)
+    return stats;
+  FlashSale *flash = activeFlashSale(counter(slot));
+  if (flash == nullptr)
+    return stats;
+
+  stats.available = flash->pool.total();
+  stats.pools = flash->pool.getPoolCount();
+  stats.admitted = flash->gate.getAdmitted();
+  stats.rejected = flash->gate.getRejected();
+  return stats;
+}
+
+// ============================================
+// RESERVATIONS
+// ============================================
+
+bool InventoryEngine::tryReserve(const string &productId, int quantity,
+                                 StockReservation &reservation) {
+  if (quantity <= 0) {
+    throw InvalidInputException("Quantity must be positive");
+  }
+
+  int slot = slotOf(productId);
+  if (slot < 0) {
+    throw ProductNotFoundException("Product not found: " + productId);
+  }
+
+  reservation.productId = productId;
+  reservation.slot = slot;
+  reservation.quantity = quantity;
+
+  StockCounter &c = counter(slot);
+  FlashSale *flash = activeFlashSale(c);
+  if (flash != nullptr) {
+    if (flash->pool.take(quantity)) {
+      reservation.fromFlashSale = true;
+      return true;
+    }
+    // Only fall back to the counter if the sale ended meanwhile
+    if (flash->active.load(memory_order_acquire))
+      return false;
+  }
+
+  int current = c.available.load(memory_order_relaxed);
+  do {
+    if (current < quantity)
+      return false;
+  } while (!c.available.compare_exchange_weak(current, current - quantity,
+                                              memory_order_acq_rel,
+                                              memory_order_relaxed));
+  c.reserved.fetch_add(quantity, memory_order_relaxed);
+  reservation.fromFlashSale = false;
+  return true;
+}
+
+void InventoryEngine::commit(const StockReservation &reservation) {
+  StockCounter &c = counter(reservation.slot);
+  if (reservation.fromFlashSale) {
+    c.flashSale.load()->pool.commit(reservation.quantity);
+  } else {
+    c.reserved.fetch_sub(reservation.quantity, memory_order_relaxed);
+  }
+}
+
+void InventoryEngine::release(const StockReservation &reservation) {
+  StockCounter &c = counter(reservation.slot);
+  if (!reservation.fromFlashSale) {
+    c.reserved.fetch_sub(reservation.quantity, memory_order_relaxed);
+    c.available.fetch_add(reservation.quantity, memory_order_acq_rel);
+    return;
+  }
+
+  FlashSale *flash = c.flashSale.load();
+  flash->pool.release(reservation.quantity);
+  // The sale may have ended while these units were out - sweep them back
+  if (!flash->active.load(memory_order_acquire)) {
+    c.available.fetch_add(flash->pool.drain(), memory_order_acq_rel);
+  }
+}
+
+vector<StockReservation>
+InventoryEngine::reserveAll(const vector<pair<string, int>> &lines) {
+  vector<StockReservation> held;
+  held.reserve(lines.size());
+
+  for (const auto &line : lines) {
+    StockReservation r;
+    bool ok = false;
+    try {
+      ok = tryReserve(line.first, line.second, r);
+    } catch (...) {
+      releaseAll(held);
+      throw;
+    }
+    if (!ok) {
+      releaseAll(held);
+      throw InsufficientStockException("Not enough stock for " + line.first);
+    }
+    held.push_back(r);
+  }
+  return held;
+}
+
+void InventoryEngine::commitAll(const vector<StockReservation> &reservations) {
+  for (const StockReservation &r : reservations)
+    commit(r);
+}
+
+void InventoryEngine::releaseAll(
+    const vector<StockReservation> &reservations) {
+  for (const StockReservation &r : reservations)
+    release(r);
+}
+
+// ============================================
+// GETTERS
+// ============================================
+
+int InventoryEngine::getAvailable(const string &productId) const {
+  int slot = slotOf(productId);
+  if (slot < 0)
+    return 0;
+  const StockCounter &c = counter(slot);
+  FlashSale *flash = c.flashSale.load();
+  return c.available.load() + (flash != nullptr ? flash->pool.total() : 0);
+}
+
+int InventoryEngine::getReserved(const string &productId) const {
+  int slot = slotOf(productId);
+  if (slot < 0)
+    return 0;
+  const StockCounter &c = counter(slot);
+  FlashSale *flash = c.flashSale.load();
+  return c.reserved.load() +
+         (flash != nullptr ? flash->pool.reservedTotal() : 0);
+}
+
+int InventoryEngine::getOnHand(const string &productId) const {
+  return getAvailable(productId) + getReserved(productId);
+}
+
+size_t InventoryEngine::getRegistryVersionCount() const {
+  lock_guard<mutex> lock(writerMutex);
+  return registryVersions.size();
+}
@@ -0,0 +1,127 @@
+#include "../include/money.h"
+#include "../include/exceptions.h"
+#include <cmath>
+#include <cstdio>
+
+// ============================================
+// CONSTRUCTORS
+// ============================================
+
+Money Money::fromCents(int64_t cents) {
+  Money m;
+  m.cents = cents;
+  return m;
+}
+
+Money Money::fromDouble(double amount) {
+  return fromCents(static_cast<int64_t>(llround(amount * 100.0)));
+}
+
+Money Money::parse(const string &text) {
+  size_t pos = 0;
+  while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos])))
+    pos++;
+
+  bool negative = false;
+  if (pos < text.size() && text[pos] == '-') {
+    negative = true;
+    pos++;
+  }
+  if (pos < text.size() && text[pos] == '$')
+    pos++;
+
+  int64_t whole = 0;
+  bool digits = false;
+  while (pos < text.size() && isdigit(static_cast<unsigned char>(text[pos]))) {
+    whole = whole * 10 + (text[pos++] - '0');
+    digits = true;
+  }
+
+  int64_t fraction = 0;
+  int fractionDigits = 0;
+  if (pos < text.size() && text[pos] == '.') {
+    pos++;
+    while (pos < text.size() &&
+           isdigit(static_cast<unsigned char>(text[pos]))) {
+      if (fractionDigits < 2) {
+        fraction = fraction * 10 + (text[pos] - '0');
+        fractionDigits++;
+      }
+      pos++;
+      digits = true;
+    }
+  }
+  if (fractionDigits == 1)
+    fraction *= 10;
+
+  if (!digits || pos != text.size()) {
+    throw InvalidInputException("Invalid amount: " + text);
+  }
+
+  int64_t cents = whole * 100 + fraction;
+  return fromCents(negative ? -cents : cents);
+}
+
+// ============================================
+// CONVERSION & DISPLAY
+// ============================================
+
+string Money::toString() const {
+  int64_t absCents = cents < 0 ? -cents : cents;
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%s%lld.%02lld", cents < 0 ? "-" : "",
+           static_cast<long long>(absCents / 100),
+           static_cast<long long>(absCents % 100));
+  return buffer;
+}
+
+// ============================================
+// ARITHMETIC
+// ============================================
+
+Money Money::operator+(const Money &other) const {
+  return fromCents(cents + other.cents);
+}
+
+Money Money::operator-(const Money &other) const {
+  return fromCents(cents - other.cents);
+}
+
+Money Money::operator*(int64_t factor) const {
+  return fromCents(cents * factor);
+}
+
+Money Money::percentOf(int percent) const {
+  int64_t scaled = cents * percent;
+  return fromCents(scaled >= 0 ? (scaled + 50) / 100 : (scaled - 50) / 100);
+}
+
+Money &Money::operator+=(const Money &other) {
+  cents += other.cents;
+  return *this;
+}
+
+Money &Money::operator-=(const Money &other) {
+  cents -= other.cents;
+  return *this;
+}
+
+// ============================================
+// BULK TOTALS
+// ============================================
+
+Money Money::sum(const int64_t *values, size_t count) {
+  // Four independent accumulators let the compiler keep the adds in
+  // vector registers instead of one serial dependency chain
+  int64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    s0 += values[i];
+    s1 += values[i + 1];
+    s2 += values[i + 2];
+    s3 += values[i + 3];
+  }
+  for (; i < count; i++)
+    s0 += values[i];
+  return fromCents(s0 + s1 + s2 + s3);
+}
@@ -1,20 +1,20 @@
 #include "../include/order.h"
 #include "../include/exceptions.h"
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
+#include <cctype>
 
 // ============================================
 // CONSTRUCTORS
 // ============================================
 
 Order::Order()
-    : id(""), customerId(0), totalAmount(0.0), status(OrderStatus::PENDING),
-      createdAt(getCurrentTimestamp()), updatedAt(createdAt) {}
+    : id(""), customerId(0), totalAmount(), status(OrderStatus::PENDING),
+      createdAt(Utils::currentEpoch()), updatedAt(createdAt) {}
 
-Order::Order(const string &id, int customerId, const vector<OrderItem> &items,
-             double total)
-    : id(id), customerId(customerId), items(items), totalAmount(total),
-      status(OrderStatus::PENDING), createdAt(getCurrentTimestamp()),
+Order::Order(const string &id, int customerId, vector<OrderItem> items,
+             Money total)
+    : id(id), customerId(customerId), items(move(items)), totalAmount(total),
+      status(OrderStatus::PENDING), createdAt(Utils::currentEpoch()),
       updatedAt(createdAt) {}
 
 // ============================================
@@ -22,22 +22,64 @@ Order::Order(const string &id, int customerId, const vector<OrderItem> &items,
 // ============================================
 
 Order Order::createFromCart(const string &orderId, int customerId,
-                            const Cart &cart) {
+                            const Cart &cart, const ProductLookup &lookup) {
   if (cart.isEmpty()) {
     throw InvalidInputException("Cannot create order from empty cart");
   }
 
   vector<OrderItem> orderItems;
+  orderItems.reserve(cart.getItemCount());
   for (const CartItem &cartItem : cart.getItems()) {
-    OrderItem item;
-    item.productId = cartItem.product.getId();
-    item.productName = cartItem.product.getName();
-    item.price = cartItem.product.getPrice();
+    const Product *product = lookup(cartItem.productId);
+    if (product == nullptr) {
+      throw ProductNotFoundException("Product no longer available: " +
+                                     cartItem.productId);
+    }
+    orderItems.emplace_back();
+    OrderItem &item = orderItems.back();
+    item.productId = cartItem.productId;
+    item.productName = product->getName();
+    item.category = product->getCategory();
+    item.price = cartItem.price;
     item.quantity = cartItem.quantity;
-    orderItems.push_back(item);
   }
 
-  return Order(orderId, customerId, orderItems, cart.getTotal());
+  Money total = computeTotal(orderItems);
+  return Order(orderId, customerId, move(orderItems), total);
+}
+
+Order Order::restore(const string &id, int customerId, vector<OrderItem> items,
+                     Money total, OrderStatus status, int64_t createdAt,
+                     int64_t updatedAt) {
+  Order order(id, customerId, move(items), total);
+  order.status = status;
+  order.createdAt = createdAt;
+  order.updatedAt = updatedAt;
+  return order;
+}
+
+Money Order::computeTotal(const vector<OrderItem> &items) {
+  // Sum in stack-sized batches so totalling never allocates
+  int64_t subtotals[64];
+  Money total;
+  for (size_t start = 0; start < items.size(); start += 64) {
+    size_t count = min<size_t>(64, items.size() - start);
+    for (size_t i = 0; i < count; i++) {
+      subtotals[i] = items[start + i].getSubtotal().getCents();
+    }
+    total += Money::sum(subtotals, count);
+  }
+  return total;
+}
+
+void Order::setDiscount(Money discount, const string &coupon) {
+  Money subtotal = computeTotal(items);
+  if (discount < Money() || discount > subtotal) {
+    throw InvalidInputException("Discount must be between 0 and the subtotal");
+  }
+  discountAmount = discount;
+  couponCode = coupon;
+  totalAmount = subtotal - discount;
 }
 
 // ============================================
@@ -73,7 +115,8 @@ void Order::displayOrder() const {
                            "", "bold")
        << endl;
   cout << Utils::colorText("║", "yellow")
-       << " Created:     " << Utils::colorText(createdAt, "white") << endl;
+       << " Created:     " << Utils::colorText(getCreatedAtString(), "white")
+       << endl;
 
   cout << Utils::colorText("╠══════════════════════════════════════════════════"
                            "═════════════╣",
@@ -83,10 +126,6 @@ void Order::displayOrder() const {
        << Utils::colorText(" Items:", "white", "", "bold") << endl;
 
   for (const OrderItem &item : items) {
-    stringstream priceStr, subtotalStr;
-    priceStr << fixed << setprecision(2) << item.price;
-    subtotalStr << fixed << setprecision(2) << item.getSubtotal();
-
     cout << Utils::colorText("║", "yellow") << "   • "
          << Utils::colorText(item.productName, "white");
 
@@ -94,8 +133,8 @@ void Order::displayOrder() const {
     for (int i = nameLen; i < 25; i++)
       cout << " ";
 
-    cout << " x" << item.quantity << " @ $" << priceStr.str() << " = "
-         << Utils::colorText("$" + subtotalStr.str(), "green") << endl;
+    cout << " x" << item.quantity << " @ " << item.price.format() << " = "
+         << Utils::colorText(item.getSubtotal().format(), "green") << endl;
   }
 
   cout << Utils::colorText("╠══════════════════════════════════════════════════"
@@ -103,12 +142,17 @@ void Order::displayOrder() const {
                            "yellow")
        << endl;
 
-  stringstream totalStr;
-  totalStr << fixed << setprecision(2) << totalAmount;
-
+  if (discountAmount > Money()) {
+    string label =
+        couponCode.empty() ? "Discount" : "Discount (" + couponCode + ")";
+    cout << Utils::colorText("║", "yellow")
+         << "                                    "
+         << Utils::colorText(label + ": -" + discountAmount.format(), "blue")
+         << endl;
+  }
   cout << Utils::colorText("║", "yellow")
        << "                                    "
-       << Utils::colorText("TOTAL: $" + totalStr.str(), "green", "", "bold")
+       << Utils::colorText("TOTAL: " + totalAmount.format(), "green", "", "bold")
        << endl;
   cout << Utils::colorText("╚══════════════════════════════════════════════════"
                            "═════════════╝",
@@ -117,77 +161,84 @@ void Order::displayOrder() const {
 }
 
 void Order::displayShort() const {
-  stringstream totalStr;
-  totalStr << fixed << setprecision(2) << totalAmount;
-
   string statusColor = status == OrderStatus::DELIVERED   ? "green"
                        : status == OrderStatus::CANCELLED ? "red"
                                                           : "yellow";
 
   cout << Utils::colorText(id, "yellow") << " | "
        << Utils::colorText(to_string(items.size()) + " items", "white") << " | "
-       << Utils::colorText("$" + totalStr.str(), "green") << " | "
+       << Utils::colorText(totalAmount.format(), "green") << " | "
        << Utils::colorText("[" + statusToString(status) + "]", statusColor)
-       << " | " << createdAt << endl;
+       << " | " << getCreatedAtString() << endl;
 }
 
 // ============================================
 // STATUS MANAGEMENT
 // ============================================
 
+// Indexed by OrderStatus
+static constexpr const char *STATUS_NAMES[ORDER_STATUS_COUNT] = {
+    "Pending", "Confirmed", "Processing", "Shipped", "Delivered", "Cancelled"};
+
+// TRANSITIONS[from][to]: the moves the order lifecycle allows
+static constexpr bool TRANSITIONS[ORDER_STATUS_COUNT][ORDER_STATUS_COUNT] = {
+    // Pend   Conf   Proc   Ship   Deliv  Cancel
+    {false, true, false, false, false, true},  // Pending
+    {false, false, true, false, false, true},  // Confirmed
+    {false, false, false, true, false, true},  // Processing
+    {false, false, false, false, true, false}, // Shipped
+    {false, false, false, false, false, false}, // Delivered
+    {false, false, false, false, false, false}, // Cancelled
+};
+
 void Order::updateStatus(OrderStatus newStatus) {
+  if (!canTransition(status, newStatus)) {
+    throw InvalidInputException("Order " + id + " cannot go from " +
+                                statusToString(status) + " to " +
+                                statusToString(newStatus));
+  }
   status = newStatus;
-  updatedAt = getCurrentTimestamp();
+  updatedAt = Utils::currentEpoch();
 }
 
-string Order::statusToString(OrderStatus status) {
-  switch (status) {
-  case OrderStatus::PENDING:
-    return "Pending";
-  case OrderStatus::CONFIRMED:
-    return "Confirmed";
-  case OrderStatus::PROCESSING:
-    return "Processing";
-  case OrderStatus::SHIPPED:
-    return "Shipped";
-  case OrderStatus::DELIVERED:
-    return "Delivered";
-  case OrderStatus::CANCELLED:
-    return "Cancelled";
-  default:
-    return "Unknown";
+bool Order::canTransition(OrderStatus from, OrderStatus to) {
+  return TRANSITIONS[static_cast<size_t>(from)][static_cast<size_t>(to)];
+}
+
+vector<OrderStatus> Order::nextStatuses(OrderStatus from) {
+  vector<OrderStatus> next;
+  for (size_t to = 0; to < ORDER_STATUS_COUNT; to++) {
+    if (TRANSITIONS[static_cast<size_t>(from)][to])
+      next.push_back(static_cast<OrderStatus>(to));
   }
+  return next;
+}
+
+string Order::statusToString(OrderStatus status) {
+  size_t index = static_cast<size_t>(status);
+  return index < ORDER_STATUS_COUNT ? STATUS_NAMES[index] : "Unknown";
 }
 
 OrderStatus Order::stringToStatus(const string &statusStr) {
-  if (statusStr == "Pending")
-    return OrderStatus::PENDING;
-  if (statusStr == "Confirmed")
-    return OrderStatus::CONFIRMED;
-  if (statusStr == "Processing")
-    return OrderStatus::PROCESSING;
-  if (statusStr == "Shipped")
-    return OrderStatus::SHIPPED;
-  if (statusStr == "Delivered")
-    return OrderStatus::DELIVERED;
-  if (statusStr == "Cancelled")
-    return OrderStatus::CANCELLED;
+  for (size_t i = 0; i < ORDER_STATUS_COUNT; i++) {
+    if (statusStr == STATUS_NAMES[i])
+      return static_cast<OrderStatus>(i);
+  }
   return OrderStatus::PENDING;
 }
 
-// ============================================
-// UTILITY
-// ============================================
-
-string Order::getCurrentTimestamp() {
-  time_t now = time(nullptr);
-  tm *ltm = localtime(&now);
-
-  stringstream ss;
-  ss << (1900 + ltm->tm_year) << "-" << setfill('0') << setw(2)
-     << (1 + ltm->tm_mon) << "-" << setfill('0') << setw(2) << ltm->tm_mday
-     << " " << setfill('0') << setw(2) << ltm->tm_hour << ":" << setfill('0')
-     << setw(2) << ltm->tm_min << ":" << setfill('0') << setw(2) << ltm->tm_sec;
-
-  return ss.str();
+bool Order::parseStatus(const string &text, OrderStatus &status) {
+  for (size_t i = 0; i < ORDER_STATUS_COUNT; i++) {
+    const char *name = STATUS_NAMES[i];
+    bool same = text.size() == char_traits<char>::length(name) &&
+                equal(text.begin(), text.end(), name, [](char a, char b) {
+                  return tolower(static_cast<unsigned char>(a)) ==
+                         tolower(static_cast<unsigned char>(b));
+                });
+    if (same) {
+      status = static_cast<OrderStatus>(i);
+      return true;
+    }
+  }
+  return false;
 }
@@ -0,0 +1,351 @@
+#include "../include/orderindex.h"
+#include "../include/exceptions.h"
+#include <algorithm>
+
+// ============================================
+// CONSTRUCTORS
+// ============================================
+
+OrderIndex::OrderIndex()
+    : byStatus(ORDER_STATUS_COUNT), createdInSlotOrder(true),
+      queues(ORDER_STATUS_COUNT) {}
+
+// ============================================
+// STATUS QUEUES
+// ============================================
+
+void OrderIndex::enqueue(uint32_t slot, OrderStatus status) {
+  StatusQueue &queue = queues[static_cast<size_t>(status)];
+  prevInQueue[slot] = queue.tail;
+  nextInQueue[slot] = NO_SLOT;
+  if (queue.tail != NO_SLOT) {
+    nextInQueue[queue.tail] = slot;
+  } else {
+    queue.head = slot;
+  }
+  queue.tail = slot;
+  queue.count++;
+}
+
+void OrderIndex::unlink(uint32_t slot, OrderStatus status) {
+  StatusQueue &queue = queues[static_cast<size_t>(status)];
+  uint32_t prev = prevInQueue[slot];
+  uint32_t next = nextInQueue[slot];
+  if (prev != NO_SLOT) {
+    nextInQueue[prev] = next;
+  } else {
+    queue.head = next;
+  }
+  if (next != NO_SLOT) {
+    prevInQueue[next] = prev;
+  } else {
+    queue.tail = prev;
+  }
+  prevInQueue[slot] = nextInQueue[slot] = NO_SLOT;
+  queue.count--;
+}
+
+// ============================================
+// MAINTENANCE
+// ============================================
+
+void OrderIndex::insertSorted(KeyedSlots &index, int64_t key, uint32_t slot) {
+  pair<int64_t, uint32_t> entry(key, slot);
+  // New orders are usually the newest and the largest slot - append
+  if (index.empty() || index.back() < entry) {
+    index.push_back(entry);
+  } else {
+    index.insert(upper_bound(index.begin(), index.end(), entry), entry);
+  }
+}
+
+void OrderIndex::rebuild(const vector<Order> &orders) {
+  slotById.clear();
+  statusBySlot.clear();
+  customerBySlot.clear();
+  createdAtBySlot.clear();
+  totalCentsBySlot.clear();
+  for (RoaringBitmap &bitmap : byStatus)
+    bitmap.clear();
+  byCustomer.clear();
+  byCreatedAt.clear();
+  byTotalCents.clear();
+  createdInSlotOrder = true;
+  queues.assign(ORDER_STATUS_COUNT, StatusQueue());
+  prevInQueue.assign(orders.size(), NO_SLOT);
+  nextInQueue.assign(orders.size(), NO_SLOT);
+
+  slotById.reserve(orders.size());
+  statusBySlot.reserve(orders.size());
+  customerBySlot.reserve(orders.size());
+  createdAtBySlot.reserve(orders.size());
+  totalCentsBySlot.reserve(orders.size());
+  byCreatedAt.reserve(orders.size());
+  byTotalCents.reserve(orders.size());
+  for (uint32_t slot = 0; slot < orders.size(); slot++) {
+    const Order &order = orders[slot];
+    if (slot > 0 && order.getCreatedAt() < createdAtBySlot.back())
+      createdInSlotOrder = false;
+    slotById[order.getId()] = slot;
+    statusBySlot.push_back(order.getStatus());
+    customerBySlot.push_back(order.getCustomerId());
+    createdAtBySlot.push_back(order.getCreatedAt());
+    totalCentsBySlot.push_back(order.getTotalAmount().getCents());
+    byStatus[static_cast<size_t>(order.getStatus())].add(slot);
+    byCustomer[order.getCustomerId()].add(slot);
+    byCreatedAt.push_back({order.getCreatedAt(), slot});
+    byTotalCents.push_back({order.getTotalAmount().getCents(), slot});
+  }
+  sort(byCreatedAt.begin(), byCreatedAt.end());
+  sort(byTotalCents.begin(), byTotalCents.end());
+
+  // Queue orders in the order they entered their current status
+  vector<pair<int64_t, uint32_t>> byUpdatedAt;
+  byUpdatedAt.reserve(orders.size());
+  for (uint32_t slot = 0; slot < orders.size(); slot++) {
+    byUpdatedAt.push_back({orders[slot].getUpdatedAt(), slot});
+  }
+  sort(byUpdatedAt.begin(), byUpdatedAt.end());
+  for (const auto &entry : byUpdatedAt) {
+    enqueue(entry.second, statusBySlot[entry.second]);
+  }
+}
+
+void OrderIndex::add(const Order &order, uint32_t slot) {
+  if (slot != statusBySlot.size()) {
+    throw InvalidInputException("Orders must be indexed in slot order");
+  }
+  if (slot > 0 && order.getCreatedAt() < createdAtBySlot.back())
+    createdInSlotOrder = false;
+  slotById[order.getId()] = slot;
+  statusBySlot.push_back(order.getStatus());
+  customerBySlot.push_back(order.getCustomerId());
+  createdAtBySlot.push_back(order.getCreatedAt());
+  totalCentsBySlot.push_back(order.getTotalAmount().getCents());
+  byStatus[static_cast<size_t>(order.getStatus())].add(slot);
+  byCustomer[order.getCustomerId()].add(slot);
+  insertSorted(byCreatedAt, order.getCreatedAt(), slot);
+  insertSorted(byTotalCents, order.getTotalAmount().getCents(), slot);
+  prevInQueue.push_back(NO_SLOT);
+  nextInQueue.push_back(NO_SLOT);
+  enqueue(slot, order.getStatus());
+}
+
+void OrderIndex::updateStatus(const string &orderId, OrderStatus newStatus) {
+  int slot = find(orderId);
+  if (slot < 0) {
+    throw InvalidInputException("Order not found: " + orderId);
+  }
+  OrderStatus &current = statusBySlot[slot];
+  if (current == newStatus)
+    return;
+  byStatus[static_cast<size_t>(current)].remove(slot);
+  byStatus[static_cast<size_t>(newStatus)].add(slot);
+  unlink(slot, current);
+  enqueue(slot, newStatus);
+  current = newStatus;
+}
+
+// ============================================
+// QUERIES
+// ============================================
+
+int OrderIndex::find(const string &orderId) const {
+  auto it = slotById.find(orderId);
+  return it == slotById.end() ? -1 : static_cast<int>(it->second);
+}
+
+size_t OrderIndex::countByStatus(OrderStatus status) const {
+  return queues[static_cast<size_t>(status)].count;
+}
+
+int OrderIndex::oldestIn(OrderStatus status) const {
+  uint32_t head = queues[static_cast<size_t>(status)].head;
+  return head == NO_SLOT ? -1 : static_cast<int>(head);
+}
+
+RoaringBitmap OrderIndex::rangeOf(const KeyedSlots &index, int64_t low,
+                                  int64_t high) {
+  RoaringBitmap slots;
+  auto it = lower_bound(index.begin(), index.end(),
+                        make_pair(low, static_cast<uint32_t>(0)));
+  for (; it != index.end() && it->first <= high; ++it) {
+    slots.add(it->second);
+  }
+  return slots;
+}
+
+size_t OrderIndex::rangeSize(const KeyedSlots &index, int64_t low,
+                             int64_t high) {
+  if (high < low)
+    return 0;
+  auto first = lower_bound(index.begin(), index.end(),
+                           make_pair(low, static_cast<uint32_t>(0)));
+  auto last = upper_bound(index.begin(), index.end(),
+                          make_pair(high, static_cast<uint32_t>(UINT32_MAX)));
+  return last - first;
+}
+
+RoaringBitmap OrderIndex::match(const OrderQuery &query,
+                                bool &filtered) const {
+  RoaringBitmap result;
+  filtered = false;
+
+  auto narrow = [&](const RoaringBitmap &slots) {
+    result = filtered ? result & slots : slots;
+    filtered = true;
+  };
+
+  if (query.customerId != 0) {
+    auto it = byCustomer.find(query.customerId);
+    narrow(it == byCustomer.end() ? RoaringBitmap() : it->second);
+  }
+  if (!query.statuses.empty()) {
+    RoaringBitmap anyStatus;
+    for (OrderStatus status : query.statuses) {
+      anyStatus = anyStatus | byStatus[static_cast<size_t>(status)];
+    }
+    narrow(anyStatus);
+  }
+  if (query.filterDates) {
+    narrow(rangeOf(byCreatedAt, query.createdFrom, query.createdTo));
+  }
+  if (query.filterTotals) {
+    narrow(rangeOf(byTotalCents, query.minTotal.getCents(),
+                   query.maxTotal.getCents()));
+  }
+  return result;
+}
+
+size_t OrderIndex::count(const OrderQuery &query) const {
+  bool filtered;
+  RoaringBitmap slots = match(query, filtered);
+  return filtered ? slots.cardinality() : size();
+}
+
+bool OrderIndex::matchesSlot(const OrderQuery &query, uint32_t slot) const {
+  if (query.customerId != 0 && customerBySlot[slot] != query.customerId)
+    return false;
+  const vector<OrderStatus> &wanted = query.statuses;
+  if (!wanted.empty() && std::find(wanted.begin(), wanted.end(),
+                                   statusBySlot[slot]) == wanted.end())
+    return false;
+  if (query.filterDates && (createdAtBySlot[slot] < query.createdFrom ||
+                            createdAtBySlot[slot] > query.createdTo))
+    return false;
+  if (query.filterTotals &&
+      (totalCentsBySlot[slot] < query.minTotal.getCents() ||
+       totalCentsBySlot[slot] > query.maxTotal.getCents()))
+    return false;
+  return true;
+}
+
+vector<uint32_t> OrderIndex::page(const OrderQuery &query,
+                                  const OrderCursor &after, size_t limit,
+                                  OrderCursor &next) const {
+  // Date range as a window of slots [first, last) when creation times
+  // rise with the slot; the walk never leaves it
+  uint32_t first = 0;
+  uint32_t last = size();
+  if (query.filterDates && createdInSlotOrder) {
+    first = lower_bound(createdAtBySlot.begin(), createdAtBySlot.end(),
+                        query.createdFrom) -
+            createdAtBySlot.begin();
+    last = upper_bound(createdAtBySlot.begin(), createdAtBySlot.end(),
+                       query.createdTo) -
+           createdAtBySlot.begin();
+    if (first >= last)
+      return {};
+  }
+
+  // Walk candidates downward from the cursor through the narrowest
+  // filter; no drivers means every slot of the window
+  vector<const RoaringBitmap *> drivers;
+  size_t narrowest = last - first;
+
+  const RoaringBitmap *customerSlots = nullptr;
+  if (query.customerId != 0) {
+    auto it = byCustomer.find(query.customerId);
+    if (it == byCustomer.end())
+      return {};
+    customerSlots = &it->second;
+    if (customerSlots->cardinality() < narrowest) {
+      narrowest = customerSlots->cardinality();
+      drivers = {customerSlots};
+    }
+  }
+  if (!query.statuses.empty()) {
+    size_t statusCount = 0;
+    for (OrderStatus status : query.statuses)
+      statusCount += byStatus[static_cast<size_t>(status)].cardinality();
+    if (statusCount < narrowest) {
+      narrowest = statusCount;
+      drivers.clear();
+      for (OrderStatus status : query.statuses)
+        drivers.push_back(&byStatus[static_cast<size_t>(status)]);
+    }
+  }
+
+  // Range filters without a slot window become bitmaps of their slots,
+  // built only when they are the narrowest
+  RoaringBitmap rangeSlots;
+  const KeyedSlots *rangeIndex = nullptr;
+  int64_t rangeLow = 0, rangeHigh = 0;
+  if (query.filterTotals) {
+    size_t totalCount = rangeSize(byTotalCents, query.minTotal.getCents(),
+                                  query.maxTotal.getCents());
+    if (totalCount < narrowest) {
+      narrowest = totalCount;
+      rangeIndex = &byTotalCents;
+      rangeLow = query.minTotal.getCents();
+      rangeHigh = query.maxTotal.getCents();
+    }
+  }
+  if (query.filterDates && !createdInSlotOrder) {
+    size_t dateCount =
+        rangeSize(byCreatedAt, query.createdFrom, query.createdTo);
+    if (dateCount < narrowest) {
+      narrowest = dateCount;
+      rangeIndex = &byCreatedAt;
+      rangeLow = query.createdFrom;
+      rangeHigh = query.createdTo;
+    }
+  }
+  if (rangeIndex != nullptr) {
+    if (narrowest == 0)
+      return {};
+    rangeSlots = rangeOf(*rangeIndex, rangeLow, rangeHigh);
+    drivers = {&rangeSlots};
+  }
+
+  vector<uint32_t> result;
+  uint32_t below = min(after.atStart ? last : after.slot, last);
+  while (result.size() < limit) {
+    uint32_t candidate = 0;
+    if (drivers.empty()) {
+      if (below <= first)
+        break;
+      candidate = below - 1;
+    } else {
+      bool found = false;
+      for (const RoaringBitmap *driver : drivers) {
+        uint32_t value;
+        if (driver->previous(below, value) && (!found || value > candidate)) {
+          candidate = value;
+          found = true;
+        }
+      }
+      if (!found || candidate < first)
+        break;
+    }
+    if (matchesSlot(query, candidate))
+      result.push_back(candidate);
+    below = candidate;
+  }
+
+  if (!result.empty()) {
+    next.slot = result.back();
+    next.atStart = false;
+  }
+  return result;
+}
@@ -0,0 +1,204 @@
+#include "../include/orderlines.h"
+#include <algorithm>
+#include <thread>
+
+// ============================================
+// LOADING
+// ============================================
+
+void OrderLineStore::clear() {
+  orderCodes.clear();
+  customerIds.clear();
+  productCodes.clear();
+  quantities.clear();
+  priceCents.clear();
+  timestamps.clear();
+  cancelled.clear();
+  orderIds.clear();
+  productIds.clear();
+  productCodeById.clear();
+}
+
+void OrderLineStore::reserve(size_t lines) {
+  orderCodes.reserve(lines);
+  customerIds.reserve(lines);
+  productCodes.reserve(lines);
+  quantities.reserve(lines);
+  priceCents.reserve(lines);
+  timestamps.reserve(lines);
+  cancelled.reserve(lines);
+}
+
+uint32_t OrderLineStore::productCode(const string &productId) {
+  auto it = productCodeById.find(productId);
+  if (it != productCodeById.end())
+    return it->second;
+  uint32_t code = productIds.size();
+  productIds.push_back(productId);
+  productCodeById[productId] = code;
+  return code;
+}
+
+void OrderLineStore::appendLine(const string &orderId, int32_t customerId,
+                                const string &productId, int32_t quantity,
+                                int64_t price, int64_t timestamp,
+                                bool isCancelled) {
+  // Lines of one order arrive together, so only a new ID gets a code
+  if (orderIds.empty() || orderIds.back() != orderId)
+    orderIds.push_back(orderId);
+  orderCodes.push_back(orderIds.size() - 1);
+  customerIds.push_back(customerId);
+  productCodes.push_back(productCode(productId));
+  quantities.push_back(quantity);
+  priceCents.push_back(price);
+  timestamps.push_back(timestamp);
+  cancelled.push_back(isCancelled ? 1 : 0);
+}
+
+void OrderLineStore::append(const Order &order) {
+  bool isCancelled = order.getStatus() == OrderStatus::CANCELLED;
+  for (const OrderItem &item : order.getItems()) {
+    appendLine(order.getId(), order.getCustomerId(), item.productId,
+               item.quantity, item.price.getCents(), order.getCreatedAt(),
+               isCancelled);
+  }
+}
+
+void OrderLineStore::build(const vector<Order> &orders) {
+  clear();
+  size_t lines = 0;
+  for (const Order &order : orders)
+    lines += order.getItems().size();
+  reserve(lines);
+  for (const Order &order : orders)
+    append(order);
+}
+
+size_t OrderLineStore::memoryBytes() const {
+  size_t bytes = size() * (sizeof(uint32_t) * 2 + sizeof(int32_t) * 2 +
+                           sizeof(int64_t) * 2 + sizeof(uint8_t));
+  for (const string &id : orderIds)
+    bytes += sizeof(string) + id.capacity();
+  for (const string &id : productIds)
+    bytes += sizeof(string) + id.capacity();
+  return bytes;
+}
+
+// ============================================
+// QUERIES
+// ============================================
+
+void OrderLineStore::aggregateRange(
+    const LineFilter &filter, LineGroupBy groupBy, size_t begin, size_t end,
+    unordered_map<int64_t, LineGroup> &groups) const {
+  const size_t BLOCK = 1024;
+  int64_t revenue[BLOCK];
+  int64_t units[BLOCK];
+  int64_t match[BLOCK];
+
+  const int64_t *ts = timestamps.data();
+  const int32_t *customers = customerIds.data();
+  const int32_t *qty = quantities.data();
+  const int64_t *price = priceCents.data();
+  const uint8_t *dead = cancelled.data();
+  const int64_t anyCustomer = filter.customerId == 0;
+  const int64_t keepCancelled = !filter.excludeCancelled;
+
+  // Product codes are dense, so product groups go in a flat array
+  vector<LineGroup> byProduct;
+  if (groupBy == LineGroupBy::PRODUCT)
+    byProduct.resize(productIds.size());
+
+  for (size_t start = begin; start < end; start += BLOCK) {
+    size_t count = min(BLOCK, end - start);
+
+    // Branch-free filter and arithmetic over the block
+    for (size_t i = 0; i < count; i++) {
+      size_t row = start + i;
+      int64_t m = static_cast<int64_t>(ts[row] >= filter.from) &
+                  static_cast<int64_t>(ts[row] <= filter.to) &
+                  (anyCustomer | static_cast<int64_t>(customers[row] ==
+                                                      filter.customerId)) &
+                  (keepCancelled | static_cast<int64_t>(dead[row] == 0));
+      match[i] = m;
+      units[i] = m * qty[row];
+      revenue[i] = units[i] * price[row];
+    }
+
+    if (groupBy == LineGroupBy::PRODUCT) {
+      const uint32_t *codes = productCodes.data() + start;
+      for (size_t i = 0; i < count; i++) {
+        LineGroup &g = byProduct[codes[i]];
+        g.revenueCents += revenue[i];
+        g.units += units[i];
+        g.lines += match[i];
+      }
+    } else {
+      for (size_t i = 0; i < count; i++) {
+        if (!match[i])
+          continue;
+        LineGroup &g = groups[customers[start + i]];
+        g.revenueCents += revenue[i];
+        g.units += units[i];
+        g.lines++;
+      }
+    }
+  }
+
+  for (size_t code = 0; code < byProduct.size(); code++) {
+    if (byProduct[code].lines == 0)
+      continue;
+    LineGroup &g = groups[code];
+    g.revenueCents += byProduct[code].revenueCents;
+    g.units += byProduct[code].units;
+    g.lines += byProduct[code].lines;
+  }
+}
+
+vector<LineGroup> OrderLineStore::aggregate(const LineFilter &filter,
+                                            LineGroupBy groupBy,
+                                            unsigned threads) const {
+  if (threads == 0)
+    threads = max(1u, thread::hardware_concurrency());
+  // Small scans are not worth a thread each
+  threads = min<size_t>(threads, max<size_t>(1, size() / 65536));
+
+  vector<unordered_map<int64_t, LineGroup>> partials(threads);
+  size_t slice = (size() + threads - 1) / threads;
+  vector<thread> workers;
+  for (unsigned t = 1; t < threads; t++) {
+    size_t begin = min(size(), t * slice);
+    size_t end = min(size(), begin + slice);
+    workers.emplace_back([&, t, begin, end]() {
+      aggregateRange(filter, groupBy, begin, end, partials[t]);
+    });
+  }
+  aggregateRange(filter, groupBy, 0, min(size(), slice), partials[0]);
+  for (thread &worker : workers)
+    worker.join();
+
+  // Merge the per-thread partials
+  unordered_map<int64_t, LineGroup> &merged = partials[0];
+  for (unsigned t = 1; t < threads; t++) {
+    for (const auto &entry : partials[t]) {
+      LineGroup &g = merged[entry.first];
+      g.revenueCents += entry.second.revenueCents;
+      g.units += entry.second.units;
+      g.lines += entry.second.lines;
+    }
+  }
+
+  vector<LineGroup> result;
+  result.reserve(merged.size());
+  for (auto &entry : merged) {
+    entry.second.key = entry.first;
+    result.push_back(entry.second);
+  }
+  sort(result.begin(), result.end(),
+       [](const LineGroup &a, const LineGroup &b) {
+         return a.revenueCents != b.revenueCents
+                    ? a.revenueCents > b.revenueCents
+                    : a.key < b.key;
+       });
+  return result;
+}
@@ -8,11 +8,10 @@
 // ============================================
 
 Product::Product()
-    : id(""), name(""), category(""), description(""), price(0.0), quantity(0) {
-}
+    : id(""), name(""), category(""), description(""), price(), quantity(0) {}
 
 Product::Product(const string &id, const string &name, const string &category,
-                 const string &description, double price, int quantity)
+                 const string &description, Money price, int quantity)
     : id(id), name(name), category(category), description(description),
       price(price), quantity(quantity) {}
 
@@ -20,7 +19,7 @@ Product::Product(const string &id, const string &name, const string &category,
 // DISPLAY METHODS
 // ============================================
 
-void Product::displayInfo() const {
+void Product::displayInfo(int lowStockThreshold) const {
   cout << Utils::colorText("┌──────────────────────────────────────────┐",
                            "yellow")
        << endl;
@@ -34,10 +33,10 @@ void Product::displayInfo() const {
   cout << Utils::colorText("│", "yellow")
        << " Category: " << Utils::colorText(category, "yellow") << endl;
   cout << Utils::colorText("│", "yellow") << " Price:    "
-       << Utils::colorText("$" + to_string(price), "green", "", "bold") << endl;
+       << Utils::colorText(price.format(), "green", "", "bold") << endl;
   cout << Utils::colorText("│", "yellow") << " Stock:    ";
 
-  if (quantity > 10) {
+  if (quantity >= lowStockThreshold) {
     cout << Utils::colorText(to_string(quantity) + " units", "green") << endl;
   } else if (quantity > 0) {
     cout << Utils::colorText(to_string(quantity) + " units (Low!)", "yellow")
@@ -52,18 +51,21 @@ void Product::displayInfo() const {
        << endl;
 }
 
-void Product::displayShort() const {
-  stringstream priceStr;
-  priceStr << fixed << setprecision(2) << price;
-
+void Product::displayShort(int held) const {
+  // Units held in carts are not available to promise to other buyers
+  int available = quantity - held;
   string stockStatus =
-      quantity > 0
-          ? Utils::colorText("[" + to_string(quantity) + " in stock]", "green")
+      available > 0
+          ? Utils::colorText("[" + to_string(available) + " in stock]", "green")
           : Utils::colorText("[Out of Stock]", "red");
+  if (held > 0) {
+    stockStatus +=
+        Utils::colorText(" (" + to_string(held) + " held)", "yellow");
+  }
 
   cout << Utils::colorText(id, "yellow") << " | "
        << Utils::colorText(name, "white", "", "bold") << " | "
-       << Utils::colorText("$" + priceStr.str(), "green") << " | "
+       << Utils::colorText(price.format(), "green") << " | "
        << Utils::colorText(category, "yellow") << " " << stockStatus << endl;
 }
 
@@ -109,8 +111,8 @@ void Product::setDescription(const string &newDescription) {
   description = newDescription;
 }
 
-void Product::setPrice(double newPrice) {
-  if (newPrice < 0) {
+void Product::setPrice(Money newPrice) {
+  if (newPrice < Money()) {
     throw InvalidInputException("Price cannot be negative");
   }
   price = newPrice;
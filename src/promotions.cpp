@@ -0,0 +1,198 @@
+#include "../include/promotions.h"
+#include "../include/exceptions.h"
+#include <algorithm>
+#include <cctype>
+#include <thread>
+
+// ============================================
+// COMPILATION
+// ============================================
+
+string PromotionEngine::normalizeCode(const string &code) {
+  string normalized;
+  for (char c : code) {
+    if (!isspace(static_cast<unsigned char>(c)))
+      normalized += toupper(static_cast<unsigned char>(c));
+  }
+  return normalized;
+}
+
+void PromotionEngine::compile(const vector<PromotionRule> &newRules) {
+  rules = newRules;
+  rulesByProduct.clear();
+  rulesByCategory.clear();
+  couponsByCode.clear();
+
+  for (uint32_t i = 0; i < rules.size(); i++) {
+    PromotionRule &rule = rules[i];
+    if (!rule.active)
+      continue;
+
+    if (rule.type == PromotionType::COUPON) {
+      if (!rule.couponCode.empty())
+        couponsByCode[normalizeCode(rule.couponCode)] = i;
+      continue;
+    }
+    if (rule.type == PromotionType::TIERED) {
+      // Highest threshold first: the first tier that fits is the best
+      sort(rule.tiers.begin(), rule.tiers.end(),
+           [](const PriceTier &a, const PriceTier &b) {
+             return a.minQuantity > b.minQuantity;
+           });
+    }
+    if (!rule.productId.empty()) {
+      rulesByProduct[rule.productId].push_back(i);
+    } else if (!rule.category.empty()) {
+      rulesByCategory[rule.category].push_back(i);
+    }
+  }
+}
+
+// ============================================
+// PRICING
+// ============================================
+
+Money PromotionEngine::lineDiscount(const PromotionRule &rule,
+                                    const CartItem &item) const {
+  switch (rule.type) {
+  case PromotionType::CATEGORY_DISCOUNT:
+    return item.getSubtotal().percentOf(rule.percent);
+  case PromotionType::BUY_X_GET_Y: {
+    int group = rule.buyQuantity + rule.freeQuantity;
+    if (rule.buyQuantity <= 0 || rule.freeQuantity <= 0)
+      return Money();
+    int freeUnits = (item.quantity / group) * rule.freeQuantity;
+    return item.price * freeUnits;
+  }
+  case PromotionType::TIERED:
+    for (const PriceTier &tier : rule.tiers) {
+      if (item.quantity >= tier.minQuantity)
+        return item.getSubtotal().percentOf(tier.percent);
+    }
+    return Money();
+  default:
+    return Money();
+  }
+}
+
+Money PromotionEngine::couponDiscount(const PromotionRule &rule,
+                                      Money subtotal) const {
+  if (subtotal < rule.minSubtotal) {
+    throw InvalidInputException("Coupon " + rule.couponCode +
+                                " needs a subtotal of at least " +
+                                rule.minSubtotal.format());
+  }
+  Money discount = rule.amountOff > Money()
+                       ? rule.amountOff
+                       : subtotal.percentOf(rule.percent);
+  return discount > subtotal ? subtotal : discount;
+}
+
+PricedCart PromotionEngine::price(const Cart &cart, const ProductLookup &lookup,
+                                  const string &couponCode) const {
+  PricedCart priced;
+  priced.lines.reserve(cart.getItemCount());
+
+  for (const CartItem &item : cart.getItems()) {
+    PricedLine line;
+    line.productId = item.productId;
+    line.quantity = item.quantity;
+    line.subtotal = item.getSubtotal();
+
+    // Only the rules filed under this product or its category
+    auto consider = [&](const vector<uint32_t> &candidates) {
+      for (uint32_t index : candidates) {
+        Money discount = lineDiscount(rules[index], item);
+        if (discount > line.discount) {
+          line.discount = discount > line.subtotal ? line.subtotal : discount;
+          line.ruleId = rules[index].id;
+        }
+      }
+    };
+    auto byProduct = rulesByProduct.find(item.productId);
+    if (byProduct != rulesByProduct.end())
+      consider(byProduct->second);
+    const Product *product = lookup(item.productId);
+    if (product != nullptr) {
+      auto byCategory = rulesByCategory.find(product->getCategory());
+      if (byCategory != rulesByCategory.end())
+        consider(byCategory->second);
+    }
+
+    priced.subtotal += line.subtotal;
+    priced.lineDiscounts += line.discount;
+    priced.lines.push_back(line);
+  }
+
+  Money afterLines = priced.subtotal - priced.lineDiscounts;
+  string code = normalizeCode(couponCode);
+  if (!code.empty()) {
+    auto coupon = couponsByCode.find(code);
+    if (coupon == couponsByCode.end()) {
+      throw InvalidInputException("Unknown coupon code: " + couponCode);
+    }
+    priced.couponDiscount = couponDiscount(rules[coupon->second], afterLines);
+    priced.couponRuleId = rules[coupon->second].id;
+  }
+
+  priced.total = afterLines - priced.couponDiscount;
+  return priced;
+}
+
+vector<PricedCart>
+PromotionEngine::repriceAll(const vector<const Cart *> &carts,
+                            const ProductLookup &lookup,
+                            unsigned threads) const {
+  vector<PricedCart> results(carts.size());
+  if (threads == 0)
+    threads = max(1u, thread::hardware_concurrency());
+  threads = min<unsigned>(threads, max<size_t>(1, carts.size()));
+
+  // Contiguous slices; every worker writes only its own result slots
+  auto work = [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+      results[i] = price(*carts[i], lookup);
+  };
+
+  size_t slice = (carts.size() + threads - 1) / threads;
+  vector<thread> workers;
+  for (unsigned t = 1; t < threads; t++) {
+    size_t begin = t * slice;
+    size_t end = min(carts.size(), begin + slice);
+    if (begin < end)
+      workers.emplace_back(work, begin, end);
+  }
+  work(0, min(carts.size(), slice));
+  for (thread &worker : workers)
+    worker.join();
+  return results;
+}
+
+// ============================================
+// RULE TYPES
+// ============================================
+
+string PromotionEngine::typeToString(PromotionType type) {
+  switch (type) {
+  case PromotionType::CATEGORY_DISCOUNT:
+    return "CATEGORY_DISCOUNT";
+  case PromotionType::BUY_X_GET_Y:
+    return "BUY_X_GET_Y";
+  case PromotionType::TIERED:
+    return "TIERED";
+  case PromotionType::COUPON:
+    return "COUPON";
+  default:
+    return "CATEGORY_DISCOUNT";
+  }
+}
+
+PromotionType PromotionEngine::stringToType(const string &typeStr) {
+  if (typeStr == "BUY_X_GET_Y")
+    return PromotionType::BUY_X_GET_Y;
+  if (typeStr == "TIERED")
+    return PromotionType::TIERED;
+  if (typeStr == "COUPON")
+    return PromotionType::COUPON;
+  return PromotionType::CATEGORY_DISCOUNT;
+}
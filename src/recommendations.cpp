@@ -0,0 +1,258 @@
+#include "../include/recommendations.h"
+#include "../include/exceptions.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+// ============================================
+// FILE PATHS
+// ============================================
+
+const string CoPurchaseRecommender::RECOMMENDATIONS_FILE =
+    "data/recommendations.txt";
+const string CoPurchaseRecommender::FORMAT_HEADER = "MXR1";
+
+// ============================================
+// CONSTRUCTORS
+// ============================================
+
+CoPurchaseRecommender::CoPurchaseRecommender(size_t topK)
+    : topK(topK), orderCount(0), matrixBuilt(false) {}
+
+// ============================================
+// BUILDING
+// ============================================
+
+uint32_t CoPurchaseRecommender::codeOf(const string &productId) {
+  auto it = codeByProduct.find(productId);
+  if (it != codeByProduct.end())
+    return it->second;
+  uint32_t code = productByCode.size();
+  productByCode.push_back(productId);
+  codeByProduct[productId] = code;
+  matrix.emplace_back();
+  return code;
+}
+
+// Distinct products in the order, sorted so each pair has one key
+vector<uint32_t> CoPurchaseRecommender::orderCodes(const Order &order) {
+  vector<uint32_t> codes;
+  codes.reserve(order.getItems().size());
+  for (const OrderItem &item : order.getItems())
+    codes.push_back(codeOf(item.productId));
+  sort(codes.begin(), codes.end());
+  codes.erase(unique(codes.begin(), codes.end()), codes.end());
+  return codes;
+}
+
+// Best `topK` entries of one matrix row, most frequent first
+static vector<Neighbour>
+topNeighbours(const unordered_map<uint32_t, uint32_t> &row,
+              const vector<string> &productByCode, size_t topK) {
+  vector<Neighbour> ranked;
+  ranked.reserve(row.size());
+  for (const auto &cell : row)
+    ranked.push_back({productByCode[cell.first], cell.second});
+
+  auto better = [](const Neighbour &a, const Neighbour &b) {
+    return a.count != b.count ? a.count > b.count : a.productId < b.productId;
+  };
+  size_t keep = min(topK, ranked.size());
+  partial_sort(ranked.begin(), ranked.begin() + keep, ranked.end(), better);
+  ranked.resize(keep);
+  return ranked;
+}
+
+void CoPurchaseRecommender::rank(uint32_t code) {
+  neighbours[productByCode[code]] =
+      topNeighbours(matrix[code], productByCode, topK);
+}
+
+void CoPurchaseRecommender::build(const vector<Order> &orders,
+                                  unsigned threads) {
+  productByCode.clear();
+  codeByProduct.clear();
+  matrix.clear();
+  neighbours.clear();
+
+  // Dictionary-encode every basket up front; workers then only read
+  vector<vector<uint32_t>> baskets;
+  baskets.reserve(orders.size());
+  for (const Order &order : orders)
+    baskets.push_back(orderCodes(order));
+
+  if (threads == 0)
+    threads = max(1u, thread::hardware_concurrency());
+  threads = min<unsigned>(threads, max<size_t>(1, baskets.size()));
+
+  // Each worker counts the pairs of its own slice of orders into its own
+  // map, keyed by (lower code, higher code)
+  vector<unordered_map<uint64_t, uint32_t>> partials(threads);
+  auto work = [&](unsigned t, size_t begin, size_t end) {
+    unordered_map<uint64_t, uint32_t> &pairs = partials[t];
+    for (size_t i = begin; i < end; i++) {
+      const vector<uint32_t> &codes = baskets[i];
+      for (size_t a = 0; a < codes.size(); a++) {
+        for (size_t b = a + 1; b < codes.size(); b++) {
+          pairs[(static_cast<uint64_t>(codes[a]) << 32) | codes[b]]++;
+        }
+      }
+    }
+  };
+
+  size_t slice = (baskets.size() + threads - 1) / threads;
+  vector<thread> workers;
+  for (unsigned t = 1; t < threads; t++) {
+    size_t begin = t * slice;
+    size_t end = min(baskets.size(), begin + slice);
+    if (begin < end)
+      workers.emplace_back(work, t, begin, end);
+  }
+  work(0, 0, min(baskets.size(), slice));
+  for (thread &worker : workers)
+    worker.join();
+
+  // Merge into the symmetric matrix
+  for (const auto &pairs : partials) {
+    for (const auto &entry : pairs) {
+      uint32_t a = entry.first >> 32;
+      uint32_t b = entry.first & 0xFFFFFFFFu;
+      matrix[a][b] += entry.second;
+      matrix[b][a] += entry.second;
+    }
+  }
+
+  // Rank rows in parallel too; every worker writes only its own slots
+  vector<vector<Neighbour>> ranked(matrix.size());
+  auto rankRange = [&](size_t begin, size_t end) {
+    for (size_t code = begin; code < end; code++)
+      ranked[code] = topNeighbours(matrix[code], productByCode, topK);
+  };
+  size_t rowSlice = (matrix.size() + threads - 1) / threads;
+  workers.clear();
+  for (unsigned t = 1; t < threads; t++) {
+    size_t begin = t * rowSlice;
+    size_t end = min(matrix.size(), begin + rowSlice);
+    if (begin < end)
+      workers.emplace_back(rankRange, begin, end);
+  }
+  rankRange(0, min(matrix.size(), rowSlice));
+  for (thread &worker : workers)
+    worker.join();
+
+  for (size_t code = 0; code < ranked.size(); code++) {
+    if (!ranked[code].empty())
+      neighbours[productByCode[code]] = move(ranked[code]);
+  }
+  orderCount = orders.size();
+  matrixBuilt = true;
+}
+
+void CoPurchaseRecommender::orderPlaced(const Order &order,
+                                        const vector<Order> &orders) {
+  if (!matrixBuilt) {
+    build(orders);
+    return;
+  }
+
+  vector<uint32_t> codes = orderCodes(order);
+  for (size_t a = 0; a < codes.size(); a++) {
+    for (size_t b = a + 1; b < codes.size(); b++) {
+      matrix[codes[a]][codes[b]]++;
+      matrix[codes[b]][codes[a]]++;
+    }
+  }
+  // Only rows this order touched can change rank
+  if (codes.size() > 1) {
+    for (uint32_t code : codes)
+      rank(code);
+  }
+  orderCount++;
+}
+
+// ============================================
+// STORAGE
+// ============================================
+
+bool CoPurchaseRecommender::load(size_t expectedOrders) {
+  ifstream file(RECOMMENDATIONS_FILE);
+  if (!file.is_open())
+    return false;
+
+  string line;
+  if (!getline(file, line))
+    return false;
+  istringstream header(line);
+  string format;
+  size_t savedOrders, savedK;
+  if (!(header >> format >> savedOrders >> savedK) ||
+      format != FORMAT_HEADER || savedOrders != expectedOrders ||
+      savedK != topK)
+    return false;
+
+  unordered_map<string, vector<Neighbour>> loaded;
+  while (getline(file, line)) {
+    istringstream fields(line);
+    string productId, entry;
+    if (!(fields >> productId))
+      continue;
+    vector<Neighbour> &list = loaded[productId];
+    while (fields >> entry) {
+      size_t colon = entry.rfind(':');
+      if (colon == string::npos)
+        return false;
+      try {
+        list.push_back({entry.substr(0, colon),
+                        static_cast<uint32_t>(stoul(entry.substr(colon + 1)))});
+      } catch (const exception &) {
+        return false; // Damaged file; caller rebuilds it
+      }
+    }
+  }
+
+  neighbours.swap(loaded);
+  orderCount = savedOrders;
+  productByCode.clear();
+  codeByProduct.clear();
+  matrix.clear();
+  matrixBuilt = false;
+  return true;
+}
+
+void CoPurchaseRecommender::save() const {
+  string tmpPath = RECOMMENDATIONS_FILE + ".tmp";
+  {
+    ofstream file(tmpPath);
+    if (!file.is_open()) {
+      throw FileException("Cannot write " + tmpPath);
+    }
+    file << FORMAT_HEADER << ' ' << orderCount << ' ' << topK << '\n';
+    for (const auto &entry : neighbours) {
+      if (entry.second.empty())
+        continue;
+      file << entry.first;
+      for (const Neighbour &n : entry.second)
+        file << ' ' << n.productId << ':' << n.count;
+      file << '\n';
+    }
+    if (!file) {
+      throw FileException("Cannot write " + tmpPath);
+    }
+  }
+  if (rename(tmpPath.c_str(), RECOMMENDATIONS_FILE.c_str()) != 0) {
+    throw FileException("Cannot replace " + RECOMMENDATIONS_FILE);
+  }
+}
+
+// ============================================
+// SERVING
+// ============================================
+
+const vector<Neighbour> &
+CoPurchaseRecommender::recommend(const string &productId) const {
+  static const vector<Neighbour> none;
+  auto it = neighbours.find(productId);
+  return it == neighbours.end() ? none : it->second;
+}
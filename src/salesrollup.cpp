@@ -0,0 +1,118 @@
+#include "../include/salesrollup.h"
+#include <algorithm>
+#include <set>
+
+// ============================================
+// MAINTENANCE
+// ============================================
+
+void SalesRollup::add(RollupRow &row, Money revenue, int64_t units,
+                      int64_t orders) {
+  row.revenue += revenue;
+  row.units += units;
+  row.orders += orders;
+}
+
+void SalesRollup::apply(const Order &order, int sign,
+                        const ProductLookup &lookup) {
+  string day = Utils::formatTimestamp(order.getCreatedAt()).substr(0, 10);
+  RollupRow &dayRow = tables.days[day];
+  add(dayRow, order.getTotalAmount() * sign, 0, sign);
+
+  // An order counts once per product and once per category it touches
+  set<string> countedCategories;
+  set<string> countedProducts;
+  for (const OrderItem &item : order.getItems()) {
+    string category = item.category;
+    if (category.empty()) {
+      const Product *product = lookup(item.productId);
+      category = product != nullptr ? product->getCategory() : "Uncategorized";
+    }
+    Money revenue = item.getSubtotal() * sign;
+    int64_t units = sign * static_cast<int64_t>(item.quantity);
+
+    dayRow.units += units;
+    add(tables.products[item.productId], revenue, units,
+        countedProducts.insert(item.productId).second ? sign : 0);
+    add(tables.categories[category], revenue, units,
+        countedCategories.insert(category).second ? sign : 0);
+  }
+}
+
+bool SalesRollup::matches(size_t orderCount, size_t cancelledCount) const {
+  return tables.orderCount == orderCount &&
+         tables.cancelledCount == cancelledCount;
+}
+
+void SalesRollup::rebuild(const vector<Order> &orders,
+                          const ProductLookup &lookup) {
+  tables = SalesRollupTables();
+  for (const Order &order : orders) {
+    tables.orderCount++;
+    if (order.getStatus() == OrderStatus::CANCELLED) {
+      tables.cancelledCount++;
+    } else {
+      apply(order, 1, lookup);
+    }
+  }
+}
+
+void SalesRollup::orderPlaced(const Order &order,
+                              const ProductLookup &lookup) {
+  tables.orderCount++;
+  apply(order, 1, lookup);
+}
+
+void SalesRollup::orderCancelled(const Order &order,
+                                 const ProductLookup &lookup) {
+  tables.cancelledCount++;
+  apply(order, -1, lookup);
+}
+
+// ============================================
+// REPORTS
+// ============================================
+
+static vector<pair<string, RollupRow>>
+topByRevenue(const map<string, RollupRow> &rows, size_t limit) {
+  vector<pair<string, RollupRow>> result;
+  for (const auto &row : rows) {
+    if (row.second.orders > 0)
+      result.push_back(row);
+  }
+  size_t keep = min(limit, result.size());
+  partial_sort(result.begin(), result.begin() + keep, result.end(),
+               [](const pair<string, RollupRow> &a,
+                  const pair<string, RollupRow> &b) {
+                 return a.second.revenue > b.second.revenue;
+               });
+  result.resize(keep);
+  return result;
+}
+
+vector<pair<string, RollupRow>> SalesRollup::recentDays(size_t limit) const {
+  vector<pair<string, RollupRow>> result;
+  for (auto it = tables.days.rbegin();
+       it != tables.days.rend() && result.size() < limit; ++it) {
+    if (it->second.orders > 0)
+      result.push_back(*it);
+  }
+  return result;
+}
+
+vector<pair<string, RollupRow>> SalesRollup::topProducts(size_t limit) const {
+  return topByRevenue(tables.products, limit);
+}
+
+vector<pair<string, RollupRow>>
+SalesRollup::topCategories(size_t limit) const {
+  return topByRevenue(tables.categories, limit);
+}
+
+RollupRow SalesRollup::getTotals() const {
+  RollupRow totals;
+  for (const auto &day : tables.days) {
+    add(totals, day.second.revenue, day.second.units, day.second.orders);
+  }
+  return totals;
+}
@@ -0,0 +1,126 @@
+#include "../include/searchcache.h"
+#include <algorithm>
+#include <sstream>
+
+// ============================================
+// CONSTRUCTORS
+// ============================================
+
+SearchCache::SearchCache(size_t capacity)
+    : capacity(capacity == 0 ? 1 : capacity) {}
+
+// ============================================
+// KEYS
+// ============================================
+
+string SearchCache::normalizeQuery(const string &query) {
+  // Lowercase, trim and collapse runs of whitespace to one space
+  string normalized;
+  bool pendingSpace = false;
+  for (char c : query) {
+    if (isspace(static_cast<unsigned char>(c))) {
+      pendingSpace = !normalized.empty();
+      continue;
+    }
+    if (pendingSpace) {
+      normalized += ' ';
+      pendingSpace = false;
+    }
+    normalized += tolower(static_cast<unsigned char>(c));
+  }
+  return normalized;
+}
+
+string SearchCache::makeKey(const string &query, const FacetQuery &filters) {
+  // Filter values are sorted so the same set in any order shares a key
+  vector<string> categories = filters.categories;
+  vector<int> priceBands = filters.priceBands;
+  vector<int> stockStates;
+  for (StockState s : filters.stockStates)
+    stockStates.push_back(static_cast<int>(s));
+
+  sort(categories.begin(), categories.end());
+  sort(priceBands.begin(), priceBands.end());
+  sort(stockStates.begin(), stockStates.end());
+
+  stringstream key;
+  key << normalizeQuery(query) << "|c:";
+  for (const string &c : categories)
+    key << c << ",";
+  key << "|p:";
+  for (int b : priceBands)
+    key << b << ",";
+  key << "|s:";
+  for (int s : stockStates)
+    key << s << ",";
+  return key.str();
+}
+
+// ============================================
+// CACHE OPERATIONS
+// ============================================
+
+bool SearchCache::lookup(const string &key, uint64_t catalogVersion,
+                         vector<string> &productIds) {
+  auto it = index.find(key);
+  if (it == index.end()) {
+    stats.misses++;
+    return false;
+  }
+
+  if (it->second->catalogVersion != catalogVersion) {
+    erase(it->second);
+    stats.invalidations++;
+    stats.misses++;
+    return false;
+  }
+
+  lru.splice(lru.begin(), lru, it->second);
+  productIds = it->second->productIds;
+  stats.hits++;
+  return true;
+}
+
+void SearchCache::store(const string &key, uint64_t catalogVersion,
+                        const vector<string> &productIds) {
+  auto it = index.find(key);
+  if (it != index.end()) {
+    erase(it->second);
+  }
+
+  while (lru.size() >= capacity) {
+    erase(prev(lru.end()));
+    stats.evictions++;
+  }
+
+  lru.push_front(Entry{key, catalogVersion, productIds, 0});
+  lru.front().bytes = entryBytes(lru.front());
+  index[key] = lru.begin();
+
+  stats.entries = lru.size();
+  stats.bytes += lru.front().bytes;
+}
+
+void SearchCache::clear() {
+  lru.clear();
+  index.clear();
+  stats.entries = 0;
+  stats.bytes = 0;
+}
+
+void SearchCache::erase(list<Entry>::iterator it) {
+  stats.bytes -= it->bytes;
+  index.erase(it->key);
+  lru.erase(it);
+  stats.entries = lru.size();
+}
+
+size_t SearchCache::entryBytes(const Entry &entry) {
+  // List node + hash node + key stored twice + result strings
+  size_t bytes = sizeof(Entry) + 2 * sizeof(void *) + 2 * entry.key.capacity();
+  bytes += sizeof(string) + 2 * sizeof(void *);
+  bytes += entry.productIds.capacity() * sizeof(string);
+  for (const string &id : entry.productIds)
+    bytes += id.capacity() > 15 ? id.capacity() : 0;
+  return bytes;
+}
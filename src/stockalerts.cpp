@@ -0,0 +1,160 @@
+#include "../include/stockalerts.h"
+#include <fstream>
+
+// ============================================
+// FILE PATHS
+// ============================================
+
+const string StockAlertMonitor::ALERT_LOG_FILE = "data/alerts.log";
+
+// ============================================
+// CONSTRUCTORS
+// ============================================
+
+StockAlertMonitor::StockAlertMonitor(int threshold)
+    : threshold(threshold), nextSequence(1) {}
+
+// ============================================
+// MONITORING
+// ============================================
+
+StockAlertMonitor::Band StockAlertMonitor::bandOf(int quantity) const {
+  if (quantity <= 0)
+    return Band::OUT;
+  if (quantity < threshold)
+    return Band::LOW;
+  return Band::NORMAL;
+}
+
+void StockAlertMonitor::seed(const vector<Product> &products) {
+  bandByProduct.clear();
+  bandByProduct.reserve(products.size());
+  for (const Product &p : products) {
+    bandByProduct[p.getId()] = bandOf(p.getQuantity());
+  }
+}
+
+void StockAlertMonitor::setThreshold(int newThreshold,
+                                     const vector<Product> &products) {
+  threshold = newThreshold;
+  seed(products);
+}
+
+void StockAlertMonitor::observe(const Product &product, int previousQuantity) {
+  Band band = bandOf(product.getQuantity());
+  auto it = bandByProduct.find(product.getId());
+  if (it == bandByProduct.end()) {
+    // New product - only worth an alert if it arrives without stock
+    bandByProduct[product.getId()] = band;
+    if (band == Band::NORMAL)
+      return;
+  } else {
+    if (it->second == band)
+      return;
+    it->second = band;
+  }
+
+  StockAlert alert;
+  alert.timestamp = time(nullptr);
+  alert.productId = product.getId();
+  alert.productName = product.getName();
+  alert.previousQuantity = previousQuantity;
+  alert.quantity = product.getQuantity();
+  alert.threshold = threshold;
+  if (band == Band::OUT) {
+    alert.type = StockAlertType::OUT_OF_STOCK;
+  } else if (band == Band::LOW) {
+    alert.type = StockAlertType::LOW_STOCK;
+  } else {
+    alert.type = StockAlertType::BACK_IN_STOCK;
+  }
+  publish(alert);
+}
+
+void StockAlertMonitor::forget(const string &productId) {
+  bandByProduct.erase(productId);
+}
+
+void StockAlertMonitor::publish(StockAlert alert) {
+  {
+    lock_guard<mutex> lock(queueMutex);
+    alert.sequence = nextSequence++;
+    recent.push_back(alert);
+    if (recent.size() > MAX_RETAINED)
+      recent.pop_front();
+  }
+  appendToLog(alert);
+}
+
+void StockAlertMonitor::appendToLog(const StockAlert &alert) const {
+  ofstream log(ALERT_LOG_FILE, ios::app);
+  if (!log.is_open())
+    return; // Alerts still reach subscribers
+
+  log << Utils::formatTimestamp(alert.timestamp) << " "
+      << typeToString(alert.type) << " " << alert.productId << " \""
+      << alert.productName << "\" " << alert.previousQuantity
+      << " -> " << alert.quantity << " (threshold " << alert.threshold << ")"
+      << endl;
+}
+
+// ============================================
+// SUBSCRIBERS
+// ============================================
+
+size_t StockAlertMonitor::subscribe() {
+  lock_guard<mutex> lock(queueMutex);
+  subscriberCursors.push_back(nextSequence);
+  return subscriberCursors.size() - 1;
+}
+
+vector<StockAlert> StockAlertMonitor::poll(size_t subscriber) {
+  lock_guard<mutex> lock(queueMutex);
+  vector<StockAlert> alerts;
+  uint64_t &cursor = subscriberCursors.at(subscriber);
+  for (const StockAlert &alert : recent) {
+    if (alert.sequence >= cursor)
+      alerts.push_back(alert);
+  }
+  cursor = nextSequence;
+  return alerts;
+}
+
+size_t StockAlertMonitor::pendingCount(size_t subscriber) const {
+  lock_guard<mutex> lock(queueMutex);
+  uint64_t cursor = subscriberCursors.at(subscriber);
+  size_t count = 0;
+  for (auto it = recent.rbegin(); it != recent.rend(); ++it) {
+    if (it->sequence < cursor)
+      break;
+    count++;
+  }
+  return count;
+}
+
+vector<StockAlert> StockAlertMonitor::getRecent(size_t limit) const {
+  lock_guard<mutex> lock(queueMutex);
+  vector<StockAlert> alerts;
+  for (auto it = recent.rbegin(); it != recent.rend() && alerts.size() < limit;
+       ++it) {
+    alerts.push_back(*it);
+  }
+  return alerts;
+}
+
+// ============================================
+// GETTERS
+// ============================================
+
+string StockAlertMonitor::typeToString(StockAlertType type) {
+  switch (type) {
+  case StockAlertType::LOW_STOCK:
+    return "LOW_STOCK";
+  case StockAlertType::OUT_OF_STOCK:
+    return "OUT_OF_STOCK";
+  case StockAlertType::BACK_IN_STOCK:
+    return "BACK_IN_STOCK";
+  default:
+    return "LOW_STOCK";
+  }
+}
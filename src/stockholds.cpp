@@ -0,0 +1,112 @@
+#include "../include/stockholds.h"
+#include <algorithm>
+
+// ============================================
+// CONSTRUCTORS
+// ============================================
+
+StockHoldManager::StockHoldManager(InventoryEngine &inventory)
+    : inventory(inventory), nextHoldId(1), expiredCount(0) {}
+
+// ============================================
+// HOLDS
+// ============================================
+
+bool StockHoldManager::placeHold(int ownerId, const string &productId,
+                                 int quantity, int ttlSeconds, time_t now) {
+  expire(now);
+
+  StockReservation reservation;
+  if (!inventory.tryReserve(productId, quantity, reservation)) {
+    return false;
+  }
+
+  uint64_t id = nextHoldId++;
+  holds[id] = StockHold{id, ownerId, reservation, now + ttlSeconds};
+  holdsByOwner[ownerId].push_back(id);
+  wheel.schedule(id, now + ttlSeconds);
+  return true;
+}
+
+vector<StockReservation> StockHoldManager::takeHolds(int ownerId) {
+  vector<StockReservation> reservations;
+  auto owner = holdsByOwner.find(ownerId);
+  if (owner == holdsByOwner.end())
+    return reservations;
+
+  for (uint64_t id : owner->second) {
+    auto it = holds.find(id);
+    if (it == holds.end())
+      continue;
+    reservations.push_back(it->second.reservation);
+    wheel.cancel(id);
+    holds.erase(it);
+  }
+  holdsByOwner.erase(owner);
+  return reservations;
+}
+
+void StockHoldManager::releaseHolds(int ownerId) {
+  inventory.releaseAll(takeHolds(ownerId));
+}
+
+size_t StockHoldManager::expire(time_t now) {
+  vector<uint64_t> due;
+  wheel.advanceTo(now, due);
+
+  for (uint64_t id : due) {
+    auto it = holds.find(id);
+    if (it == holds.end())
+      continue;
+    inventory.release(it->second.reservation);
+    forget(id);
+  }
+  expiredCount += due.size();
+  return due.size();
+}
+
+void StockHoldManager::forget(uint64_t holdId) {
+  auto it = holds.find(holdId);
+  if (it == holds.end())
+    return;
+
+  vector<uint64_t> &ownerHolds = holdsByOwner[it->second.ownerId];
+  ownerHolds.erase(remove(ownerHolds.begin(), ownerHolds.end(), holdId),
+                   ownerHolds.end());
+  if (ownerHolds.empty())
+    holdsByOwner.erase(it->second.ownerId);
+  holds.erase(it);
+}
+
+// ============================================
+// GETTERS
+// ============================================
+
+int StockHoldManager::getHeldQuantity(int ownerId,
+                                      const string &productId) const {
+  auto owner = holdsByOwner.find(ownerId);
+  if (owner == holdsByOwner.end())
+    return 0;
+
+  int total = 0;
+  for (uint64_t id : owner->second) {
+    const StockHold &hold = holds.at(id);
+    if (hold.reservation.productId == productId)
+      total += hold.reservation.quantity;
+  }
+  return total;
+}
+
+time_t StockHoldManager::getEarliestExpiry(int ownerId) const {
+  auto owner = holdsByOwner.find(ownerId);
+  if (owner == holdsByOwner.end())
+    return 0;
+
+  time_t earliest = 0;
+  for (uint64_t id : owner->second) {
+    time_t expiresAt = holds.at(id).expiresAt;
+    if (earliest == 0 || expiresAt < earliest)
+      earliest = expiresAt;
+  }
+  return earliest;
+}
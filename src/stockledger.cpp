@@ -0,0 +1,329 @@
+#include "../include/stockledger.h"
+#include "../include/exceptions.h"
+#include "../lib/json.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+using json = nlohmann::ordered_json;
+
+// ============================================
+// FILE PATHS
+// ============================================
+
+const string StockLedger::LEDGER_FILE = "data/stock_ledger.jsonl";
+const string StockLedger::SNAPSHOT_FILE = "data/stock_snapshot.json";
+const string StockLedger::INDEX_FILE = "data/stock_ledger.idx";
+
+// ============================================
+// CONSTRUCTORS
+// ============================================
+
+StockLedger::StockLedger()
+    : logSize(0), indexedUpTo(0), nextSequence(1), entriesSinceSnapshot(0) {}
+
+// ============================================
+// LOG
+// ============================================
+
+static uint64_t fileSize(const string &path) {
+  ifstream file(path, ios::binary | ios::ate);
+  if (!file.is_open())
+    return 0;
+  return static_cast<uint64_t>(file.tellg());
+}
+
+static StockEvent eventFromJson(const json &j) {
+  StockEvent event;
+  event.sequence = j.at("seq").get<uint64_t>();
+  event.timestamp = static_cast<time_t>(j.at("ts").get<int64_t>());
+  event.productId = j.at("product").get<string>();
+  event.type = StockLedger::stringToType(j.at("type").get<string>());
+  event.delta = j.at("delta").get<int>();
+  event.balance = j.at("balance").get<int>();
+  event.reference = j.value("ref", "");
+  return event;
+}
+
+void StockLedger::open() {
+  if (log.is_open())
+    log.close();
+  levels.clear();
+  nextSequence = 1;
+  entriesSinceSnapshot = 0;
+
+  uint64_t covered = 0;
+  uint64_t size = fileSize(LEDGER_FILE);
+  if (!loadSnapshot(covered) || covered > size) {
+    // No usable snapshot (or the log was replaced) - replay everything
+    levels.clear();
+    nextSequence = 1;
+    covered = 0;
+  }
+  loadIndex(size);
+
+  // Balances are absolute, so replaying from the last indexed entry when
+  // the index lags the snapshot still ends at the right levels
+  uint64_t from = indexedUpTo == 0 ? 0 : min(covered, indexedUpTo - 1);
+  replay(from, covered);
+  indexLog.flush();
+
+  log.open(LEDGER_FILE, ios::app | ios::binary);
+  if (!log.is_open()) {
+    throw FileException("Cannot open " + LEDGER_FILE);
+  }
+  logSize = size;
+
+  // A crash mid-append can leave a partial last line; start a fresh one
+  if (logSize > 0) {
+    ifstream tail(LEDGER_FILE, ios::binary);
+    tail.seekg(logSize - 1);
+    if (tail.get() != '\n') {
+      log << '\n';
+      log.flush();
+      logSize++;
+    }
+  }
+}
+
+bool StockLedger::loadSnapshot(uint64_t &coveredBytes) {
+  ifstream file(SNAPSHOT_FILE);
+  if (!file.is_open())
+    return false;
+
+  try {
+    json j;
+    file >> j;
+    coveredBytes = j.at("logBytes").get<uint64_t>();
+    nextSequence = j.at("sequence").get<uint64_t>() + 1;
+    for (auto &entry : j.at("levels").items()) {
+      levels[entry.key()] = entry.value().get<int>();
+    }
+    return true;
+  } catch (const exception &) {
+    return false;
+  }
+}
+
+void StockLedger::loadIndex(uint64_t ledgerBytes) {
+  if (indexLog.is_open())
+    indexLog.close();
+  offsetsByProduct.clear();
+  indexedUpTo = 0;
+
+  uint64_t validBytes = 0;
+  {
+    ifstream file(INDEX_FILE, ios::binary);
+    string line;
+    while (file.is_open() && getline(file, line)) {
+      if (file.eof())
+        break; // Partial last line from an interrupted write
+
+      // Offsets only grow and must point inside the current log;
+      // anything else means the log was replaced - rebuild the index
+      size_t space = line.find(' ');
+      uint64_t offset = 0;
+      try {
+        offset = stoull(line.substr(0, space));
+      } catch (const exception &) {
+        space = string::npos;
+      }
+      if (space == string::npos || space + 1 == line.size() ||
+          offset < indexedUpTo || offset >= ledgerBytes) {
+        offsetsByProduct.clear();
+        indexedUpTo = 0;
+        validBytes = 0;
+        break;
+      }
+      offsetsByProduct[line.substr(space + 1)].push_back(offset);
+      indexedUpTo = offset + 1;
+      validBytes += line.size() + 1;
+    }
+  }
+
+  // Drop whatever follows the last good line before appending to it
+  error_code ec;
+  if (filesystem::exists(INDEX_FILE, ec) &&
+      filesystem::file_size(INDEX_FILE, ec) != validBytes) {
+    filesystem::resize_file(INDEX_FILE, validBytes, ec);
+    if (ec) {
+      throw FileException("Cannot truncate " + INDEX_FILE);
+    }
+  }
+
+  indexLog.open(INDEX_FILE, ios::app | ios::binary);
+  if (!indexLog.is_open()) {
+    throw FileException("Cannot open " + INDEX_FILE);
+  }
+}
+
+void StockLedger::replay(uint64_t fromOffset, uint64_t coveredBytes) {
+  ifstream file(LEDGER_FILE, ios::binary);
+  if (!file.is_open())
+    return;
+  file.seekg(fromOffset);
+
+  string line;
+  uint64_t offset = fromOffset;
+  while (getline(file, line)) {
+    uint64_t lineOffset = offset;
+    offset += line.size() + 1;
+    if (line.empty())
+      continue;
+    try {
+      apply(eventFromJson(json::parse(line)), lineOffset);
+      if (lineOffset >= coveredBytes)
+        entriesSinceSnapshot++;
+    } catch (const exception &) {
+      // Partial line from an interrupted write - skip it
+    }
+  }
+}
+
+void StockLedger::apply(const StockEvent &event, uint64_t offset) {
+  levels[event.productId] = event.balance;
+  if (offset >= indexedUpTo) {
+    offsetsByProduct[event.productId].push_back(offset);
+    indexLog << offset << ' ' << event.productId << '\n';
+    indexedUpTo = offset + 1;
+  }
+  if (event.sequence >= nextSequence)
+    nextSequence = event.sequence + 1;
+}
+
+int StockLedger::record(const string &productId, StockEventType type,
+                        int delta, const string &reference) {
+  if (!log.is_open()) {
+    throw FileException("Stock ledger is not open");
+  }
+
+  StockEvent event;
+  event.sequence = nextSequence;
+  event.timestamp = time(nullptr);
+  event.productId = productId;
+  event.type = type;
+  event.delta = delta;
+  event.balance = getLevel(productId) + delta;
+  event.reference = reference;
+
+  json j;
+  j["seq"] = event.sequence;
+  j["ts"] = static_cast<int64_t>(event.timestamp);
+  j["product"] = event.productId;
+  j["type"] = typeToString(event.type);
+  j["delta"] = event.delta;
+  j["balance"] = event.balance;
+  j["ref"] = event.reference;
+  string line = j.dump();
+
+  // Written and flushed before any caller updates products.json, so the
+  // ledger is never behind the catalog
+  log << line << '\n';
+  log.flush();
+  if (!log) {
+    throw FileException("Cannot write " + LEDGER_FILE);
+  }
+
+  apply(event, logSize);
+  logSize += line.size() + 1;
+  indexLog.flush(); // A missed index line is re-added at the next open
+
+  if (++entriesSinceSnapshot >= SNAPSHOT_INTERVAL) {
+    writeSnapshot();
+  }
+  return event.balance;
+}
+
+void StockLedger::writeSnapshot() {
+  json j;
+  j["sequence"] = nextSequence - 1;
+  j["logBytes"] = logSize;
+  j["levels"] = json::object();
+  for (const auto &entry : levels)
+    j["levels"][entry.first] = entry.second;
+
+  // Write beside the old snapshot and rename, so a crash never leaves a
+  // half-written one behind
+  string tmpPath = SNAPSHOT_FILE + ".tmp";
+  {
+    ofstream file(tmpPath);
+    if (!file.is_open()) {
+      throw FileException("Cannot write " + tmpPath);
+    }
+    file << j.dump() << endl;
+  }
+  if (rename(tmpPath.c_str(), SNAPSHOT_FILE.c_str()) != 0) {
+    throw FileException("Cannot replace " + SNAPSHOT_FILE);
+  }
+  entriesSinceSnapshot = 0;
+}
+
+// ============================================
+// QUERIES
+// ============================================
+
+bool StockLedger::hasProduct(const string &productId) const {
+  return levels.count(productId) > 0;
+}
+
+int StockLedger::getLevel(const string &productId) const {
+  auto it = levels.find(productId);
+  return it == levels.end() ? 0 : it->second;
+}
+
+vector<StockEvent> StockLedger::history(const string &productId,
+                                        size_t limit) const {
+  vector<StockEvent> events;
+  auto it = offsetsByProduct.find(productId);
+  if (it == offsetsByProduct.end())
+    return events;
+
+  ifstream file(LEDGER_FILE, ios::binary);
+  if (!file.is_open()) {
+    throw FileException("Cannot open " + LEDGER_FILE);
+  }
+
+  const vector<uint64_t> &offsets = it->second;
+  string line;
+  for (size_t i = offsets.size(); i > 0 && events.size() < limit; i--) {
+    file.clear();
+    file.seekg(offsets[i - 1]);
+    if (!getline(file, line))
+      continue;
+    try {
+      events.push_back(eventFromJson(json::parse(line)));
+    } catch (const exception &) {
+      continue;
+    }
+  }
+  return events;
+}
+
+// ============================================
+// EVENT TYPES
+// ============================================
+
+string StockLedger::typeToString(StockEventType type) {
+  switch (type) {
+  case StockEventType::SALE:
+    return "SALE";
+  case StockEventType::RESTOCK:
+    return "RESTOCK";
+  case StockEventType::ADJUSTMENT:
+    return "ADJUSTMENT";
+  case StockEventType::CANCELLATION:
+    return "CANCELLATION";
+  default:
+    return "ADJUSTMENT";
+  }
+}
+
+StockEventType StockLedger::stringToType(const string &typeStr) {
+  if (typeStr == "SALE")
+    return StockEventType::SALE;
+  if (typeStr == "RESTOCK")
+    return StockEventType::RESTOCK;
+  if (typeStr == "CANCELLATION")
+    return StockEventType::CANCELLATION;
+  return StockEventType::ADJUSTMENT;
+}
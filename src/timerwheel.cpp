@@ -0,0 +1,98 @@
+#include "../include/timerwheel.h"
+
+// ============================================
+// CONSTRUCTORS
+// ============================================
+
+TimerWheel::TimerWheel() : slots(LEVELS * SLOTS), now(0) {}
+
+// ============================================
+// INTERNALS
+// ============================================
+
+list<TimerWheel::Timer> &TimerWheel::bucket(int level, int slot) {
+  return slots[level * SLOTS + slot];
+}
+
+void TimerWheel::place(const Timer &timer) {
+  int64_t maxDelay = (int64_t(1) << (SLOT_BITS * LEVELS)) - 1;
+  int64_t expiry = timer.expiry <= now ? now + 1 : timer.expiry;
+  if (expiry - now > maxDelay)
+    expiry = now + maxDelay;
+
+  // Lowest level whose block (the bits above it) matches the clock
+  int level = 0;
+  while (level < LEVELS - 1 &&
+         (expiry >> (SLOT_BITS * (level + 1))) !=
+             (now >> (SLOT_BITS * (level + 1)))) {
+    level++;
+  }
+
+  int slot = (expiry >> (SLOT_BITS * level)) & (SLOTS - 1);
+  list<Timer> &b = bucket(level, slot);
+  b.push_front(Timer{timer.id, expiry});
+  locations[timer.id] = Location{level, slot, b.begin()};
+}
+
+void TimerWheel::cascade(int level) {
+  int slot = (now >> (SLOT_BITS * level)) & (SLOTS - 1);
+  list<Timer> pending;
+  pending.swap(bucket(level, slot));
+  for (const Timer &t : pending) {
+    locations.erase(t.id);
+    place(t);
+  }
+}
+
+// ============================================
+// TIMERS
+// ============================================
+
+void TimerWheel::schedule(uint64_t id, int64_t expiry) {
+  cancel(id);
+  place(Timer{id, expiry});
+}
+
+bool TimerWheel::cancel(uint64_t id) {
+  auto it = locations.find(id);
+  if (it == locations.end())
+    return false;
+  bucket(it->second.level, it->second.slot).erase(it->second.it);
+  locations.erase(it);
+  return true;
+}
+
+void TimerWheel::advanceTo(int64_t time, vector<uint64_t> &expired) {
+  if (locations.empty()) {
+    // Nothing pending - jump straight there
+    if (time > now)
+      now = time;
+    return;
+  }
+
+  while (now < time) {
+    now++;
+
+    // Refill lower levels from the level above whenever they wrap
+    for (int level = 1; level < LEVELS; level++) {
+      if ((now & ((int64_t(1) << (SLOT_BITS * level)) - 1)) != 0)
+        break;
+      cascade(level);
+    }
+
+    list<Timer> &due = bucket(0, now & (SLOTS - 1));
+    for (auto it = due.begin(); it != due.end();) {
+      if (it->expiry <= now) {
+        expired.push_back(it->id);
+        locations.erase(it->id);
+        it = due.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    if (locations.empty()) {
+      now = time;
+    }
+  }
+}
@@ -1,6 +1,8 @@
 #include "../include/utils.h"
 #include <chrono>
+#include <cstdio>
 #include <cstdlib>
+#include <ctime>
 #include <iostream>
 #include <limits>
 #include <map>
@@ -182,3 +184,64 @@ int Utils::getMenuChoice(const string &prompt, int minOption, int maxOption) {
     }
   }
 }
+
+// ============================================
+// TIME FUNCTIONS
+// ============================================
+
+int64_t Utils::currentEpoch() { return static_cast<int64_t>(time(nullptr)); }
+
+static void writeDigits(char *out, int value, int width) {
+  for (int i = width - 1; i >= 0; i--) {
+    out[i] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+}
+
+string Utils::formatTimestamp(int64_t epoch) {
+  // Each thread remembers the last second it formatted; order lists and
+  // log lines written in the same second skip localtime_r entirely
+  const size_t LENGTH = 19; // "YYYY-MM-DD HH:MM:SS"
+  thread_local int64_t cachedEpoch = -1;
+  thread_local char cachedText[LENGTH];
+
+  if (epoch != cachedEpoch) {
+    time_t seconds = static_cast<time_t>(epoch);
+    tm local;
+    if (localtime_r(&seconds, &local) == nullptr) {
+      return to_string(epoch); // Out of range for the C library
+    }
+    char *out = cachedText;
+    writeDigits(out, 1900 + local.tm_year, 4);
+    out[4] = '-';
+    writeDigits(out + 5, 1 + local.tm_mon, 2);
+    out[7] = '-';
+    writeDigits(out + 8, local.tm_mday, 2);
+    out[10] = ' ';
+    writeDigits(out + 11, local.tm_hour, 2);
+    out[13] = ':';
+    writeDigits(out + 14, local.tm_min, 2);
+    out[16] = ':';
+    writeDigits(out + 17, local.tm_sec, 2);
+    cachedEpoch = epoch;
+  }
+  return string(cachedText, LENGTH);
+}
+
+int64_t Utils::parseTimestamp(const string &text) {
+  tm local = {};
+  int fields = sscanf(text.c_str(), "%d-%d-%d %d:%d:%d", &local.tm_year,
+                      &local.tm_mon, &local.tm_mday, &local.tm_hour,
+                      &local.tm_min, &local.tm_sec);
+  if (fields != 3 && fields != 5 && fields != 6)
+    return -1;
+  if (local.tm_mon < 1 || local.tm_mon > 12 || local.tm_mday < 1 ||
+      local.tm_mday > 31)
+    return -1;
+
+  local.tm_year -= 1900;
+  local.tm_mon -= 1;
+  local.tm_isdst = -1; // Let mktime work out daylight saving
+  time_t epoch = mktime(&local);
+  return epoch == static_cast<time_t>(-1) ? -1 : static_cast<int64_t>(epoch);
+}
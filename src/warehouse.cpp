@@ -0,0 +1,295 @@
+#include "../include/warehouse.h"
+#include "../include/exceptions.h"
+#include <algorithm>
+#include <cctype>
+
+// ============================================
+// CONSTRUCTORS
+// ============================================
+
+WarehouseStock::WarehouseStock() {
+  warehouses.push_back({"MAIN", "Main Warehouse", ""});
+}
+
+// ============================================
+// ROWS
+// ============================================
+
+size_t WarehouseStock::rowOf(const string &productId) const {
+  auto it = rowByProduct.find(productId);
+  if (it == rowByProduct.end()) {
+    throw ProductNotFoundException("No warehouse stock for " + productId);
+  }
+  return it->second;
+}
+
+size_t WarehouseStock::ensureRow(const string &productId) {
+  auto it = rowByProduct.find(productId);
+  if (it != rowByProduct.end())
+    return it->second;
+
+  size_t row;
+  if (!freeRows.empty()) {
+    row = freeRows.back();
+    freeRows.pop_back();
+    productByRow[row] = productId;
+  } else {
+    row = productByRow.size();
+    productByRow.push_back(productId);
+    totals.push_back(0);
+    cells.resize(cells.size() + warehouses.size(), 0);
+  }
+  rowByProduct[productId] = row;
+  return row;
+}
+
+int &WarehouseStock::cell(size_t row, size_t location) {
+  return cells[row * warehouses.size() + location];
+}
+
+int WarehouseStock::cell(size_t row, size_t location) const {
+  return cells[row * warehouses.size() + location];
+}
+
+// ============================================
+// LOADING
+// ============================================
+
+void WarehouseStock::load(const vector<Warehouse> &newWarehouses,
+                          const WarehouseStockMap &stock) {
+  if (newWarehouses.empty()) {
+    throw InvalidInputException("At least one warehouse is required");
+  }
+
+  warehouses = newWarehouses;
+  rowByProduct.clear();
+  productByRow.clear();
+  cells.clear();
+  totals.clear();
+  freeRows.clear();
+
+  for (const auto &product : stock) {
+    size_t row = ensureRow(product.first);
+    for (const auto &entry : product.second) {
+      int location = findWarehouse(entry.first);
+      if (location < 0 || entry.second <= 0)
+        continue; // Unknown location or nothing there
+      cell(row, location) += entry.second;
+      totals[row] += entry.second;
+    }
+  }
+}
+
+WarehouseStockMap WarehouseStock::toMap() const {
+  WarehouseStockMap stock;
+  for (const auto &entry : rowByProduct) {
+    map<string, int> &locations = stock[entry.first];
+    for (size_t loc = 0; loc < warehouses.size(); loc++) {
+      locations[warehouses[loc].id] = cell(entry.second, loc);
+    }
+  }
+  return stock;
+}
+
+bool WarehouseStock::reconcile(const string &productId, int quantity) {
+  size_t row = ensureRow(productId);
+  int delta = quantity - totals[row];
+  if (delta == 0)
+    return false;
+
+  if (delta > 0) {
+    cell(row, 0) += delta;
+  } else {
+    int toRemove = -delta;
+    for (size_t loc = 0; loc < warehouses.size() && toRemove > 0; loc++) {
+      int taken = min(cell(row, loc), toRemove);
+      cell(row, loc) -= taken;
+      toRemove -= taken;
+    }
+  }
+  totals[row] = quantity;
+  return true;
+}
+
+// ============================================
+// LOCATIONS
+// ============================================
+
+size_t WarehouseStock::addWarehouse(const Warehouse &warehouse) {
+  if (warehouse.id.empty() || findWarehouse(warehouse.id) >= 0) {
+    throw InvalidInputException("Warehouse ID must be new and non-empty");
+  }
+
+  // Widen every row by one column
+  size_t oldStride = warehouses.size();
+  size_t newStride = oldStride + 1;
+  vector<int> widened(productByRow.size() * newStride, 0);
+  for (size_t row = 0; row < productByRow.size(); row++) {
+    copy(cells.begin() + row * oldStride, cells.begin() + (row + 1) * oldStride,
+         widened.begin() + row * newStride);
+  }
+  cells.swap(widened);
+  warehouses.push_back(warehouse);
+  return warehouses.size() - 1;
+}
+
+int WarehouseStock::findWarehouse(const string &warehouseId) const {
+  for (size_t i = 0; i < warehouses.size(); i++) {
+    if (warehouses[i].id == warehouseId)
+      return i;
+  }
+  return -1;
+}
+
+static string lowercase(string text) {
+  for (char &c : text)
+    c = tolower(static_cast<unsigned char>(c));
+  return text;
+}
+
+vector<size_t>
+WarehouseStock::locationsByDistance(const string &address) const {
+  string haystack = lowercase(address);
+  vector<size_t> near;
+  vector<size_t> far;
+  for (size_t i = 0; i < warehouses.size(); i++) {
+    const string &region = warehouses[i].region;
+    if (!region.empty() && haystack.find(lowercase(region)) != string::npos) {
+      near.push_back(i);
+    } else {
+      far.push_back(i);
+    }
+  }
+  near.insert(near.end(), far.begin(), far.end());
+  return near;
+}
+
+// ============================================
+// STOCK
+// ============================================
+
+int WarehouseStock::getTotal(const string &productId) const {
+  auto it = rowByProduct.find(productId);
+  return it == rowByProduct.end() ? 0 : totals[it->second];
+}
+
+int WarehouseStock::getAt(const string &productId, size_t location) const {
+  auto it = rowByProduct.find(productId);
+  if (it == rowByProduct.end() || location >= warehouses.size())
+    return 0;
+  return cell(it->second, location);
+}
+
+void WarehouseStock::add(const string &productId, size_t location,
+                         int delta) {
+  if (location >= warehouses.size()) {
+    throw InvalidInputException("Unknown warehouse");
+  }
+  size_t row = ensureRow(productId);
+  if (cell(row, location) + delta < 0) {
+    throw InsufficientStockException("Not enough stock at " +
+                                     warehouses[location].name);
+  }
+  cell(row, location) += delta;
+  totals[row] += delta;
+}
+
+void WarehouseStock::removeProduct(const string &productId) {
+  auto it = rowByProduct.find(productId);
+  if (it == rowByProduct.end())
+    return;
+  size_t row = it->second;
+  fill(cells.begin() + row * warehouses.size(),
+       cells.begin() + (row + 1) * warehouses.size(), 0);
+  totals[row] = 0;
+  productByRow[row].clear();
+  freeRows.push_back(row);
+  rowByProduct.erase(it);
+}
+
+// ============================================
+// ALLOCATION
+// ============================================
+
+Allocation WarehouseStock::allocate(const vector<pair<string, int>> &lines,
+                                    const string &address) const {
+  // Merge duplicate lines and resolve rows once
+  vector<pair<size_t, int>> remaining; // row, units still to place
+  for (const auto &line : lines) {
+    size_t row = rowOf(line.first);
+    auto it = find_if(
+        remaining.begin(), remaining.end(),
+        [row](const pair<size_t, int> &r) { return r.first == row; });
+    if (it != remaining.end()) {
+      it->second += line.second;
+    } else {
+      remaining.push_back({row, line.second});
+    }
+  }
+
+  Allocation allocation;
+  vector<size_t> order = locationsByDistance(address);
+
+  // One shipment if any single location holds the whole order
+  for (size_t loc : order) {
+    bool coversAll = true;
+    for (const auto &r : remaining) {
+      if (cell(r.first, loc) < r.second) {
+        coversAll = false;
+        break;
+      }
+    }
+    if (coversAll) {
+      for (const auto &r : remaining) {
+        allocation.lines.push_back({productByRow[r.first], loc, r.second});
+      }
+      allocation.locations.push_back(loc);
+      return allocation;
+    }
+  }
+
+  // Otherwise greedy set cover: take the location covering the most
+  // outstanding units until nothing is left
+  vector<bool> used(warehouses.size(), false);
+  int outstanding = 0;
+  for (const auto &r : remaining)
+    outstanding += r.second;
+
+  while (outstanding > 0) {
+    int bestCovered = 0;
+    size_t best = 0;
+    for (size_t loc : order) {
+      if (used[loc])
+        continue;
+      int covered = 0;
+      for (const auto &r : remaining)
+        covered += min(cell(r.first, loc), r.second);
+      if (covered > bestCovered) {
+        bestCovered = covered;
+        best = loc;
+      }
+    }
+    if (bestCovered == 0) {
+      throw InsufficientStockException(
+          "Warehouses cannot cover this order");
+    }
+
+    used[best] = true;
+    allocation.locations.push_back(best);
+    for (auto &r : remaining) {
+      int taken = min(cell(r.first, best), r.second);
+      if (taken > 0) {
+        allocation.lines.push_back({productByRow[r.first], best, taken});
+        r.second -= taken;
+      }
+    }
+    outstanding -= bestCovered;
+  }
+  return allocation;
+}
+
+void WarehouseStock::ship(const Allocation &allocation) {
+  for (const AllocationLine &line : allocation.lines) {
+    add(line.productId, line.location, -line.quantity);
+  }
+}
@@ -0,0 +1,186 @@
+// Multi-threaded stress run for InventoryEngine. Exits non-zero on the
+// first broken invariant. Build and run with `make stress`.
+//
+//   oversell    - many threads reserve, then commit or release, one hot
+//                 product; units sold never exceed the stock
+//   carts       - reserveAll on overlapping carts is all-or-nothing
+//   flash sale  - the same invariant through the per-core sub-pools
+//   registry    - lookups keep resolving while products are registered
+//                 concurrently, and replaced snapshots are reclaimed
+
+#include "../include/exceptions.h"
+#include "../include/inventory.h"
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static const int THREADS = 8;
+
+#define CHECK(condition, message)                                              \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      cerr << "FAILED: " << message << " (" #condition ")" << endl;            \
+      exit(1);                                                                 \
+    }                                                                          \
+  } while (0)
+
+static vector<Product> catalog(int products, int stockEach) {
+  vector<Product> list;
+  for (int i = 0; i < products; i++) {
+    list.emplace_back("S" + to_string(i), "Stress " + to_string(i), "Test", "",
+                      Money::fromCents(100), stockEach);
+  }
+  return list;
+}
+
+static void runThreads(const function<void(int)> &work) {
+  vector<thread> workers;
+  for (int t = 0; t < THREADS; t++)
+    workers.emplace_back(work, t);
+  for (thread &worker : workers)
+    worker.join();
+}
+
+// ============================================
+// OVERSELL
+// ============================================
+
+static void testOversell(bool flashSale) {
+  const int STOCK = 5000;
+  InventoryEngine engine;
+  engine.load(catalog(1, STOCK));
+  if (flashSale)
+    engine.startFlashSale("S0", 1000000, 1000000);
+
+  atomic<int> sold{0};
+  runThreads([&](int t) {
+    mt19937 random(t);
+    for (int i = 0; i < 20000; i++) {
+      if (!engine.admit("S0"))
+        continue;
+      StockReservation reservation;
+      if (!engine.tryReserve("S0", 1 + random() % 3, reservation))
+        continue;
+      if (random() % 4 == 0) {
+        engine.release(reservation);
+      } else {
+        engine.commit(reservation);
+        sold += reservation.quantity;
+      }
+    }
+  });
+
+  CHECK(sold <= STOCK, "sold more than the stock");
+  CHECK(engine.getReserved("S0") == 0, "reservations left behind");
+  CHECK(sold + engine.getAvailable("S0") == STOCK, "units lost or created");
+  cout << (flashSale ? "flash sale" : "oversell  ") << "  ok: " << sold
+       << " of " << STOCK << " sold" << endl;
+}
+
+// ============================================
+// CARTS
+// ============================================
+
+static void testCarts() {
+  const int PRODUCTS = 4;
+  const int STOCK = 3000;
+  InventoryEngine engine;
+  engine.load(catalog(PRODUCTS, STOCK));
+
+  vector<atomic<int>> sold(PRODUCTS);
+  runThreads([&](int t) {
+    mt19937 random(100 + t);
+    for (int i = 0; i < 10000; i++) {
+      // Two or three distinct products per cart
+      vector<pair<string, int>> lines;
+      int first = random() % PRODUCTS;
+      int count = 2 + random() % 2;
+      for (int k = 0; k < count; k++)
+        lines.push_back({"S" + to_string((first + k) % PRODUCTS),
+                         1 + static_cast<int>(random() % 4)});
+      try {
+        vector<StockReservation> held = engine.reserveAll(lines);
+        CHECK(held.size() == lines.size(), "partial cart reservation");
+        if (random() % 3 == 0) {
+          engine.releaseAll(held);
+        } else {
+          engine.commitAll(held);
+          for (const StockReservation &r : held)
+            sold[r.productId[1] - '0'] += r.quantity;
+        }
+      } catch (const InsufficientStockException &) {
+        // Nothing may stay reserved after a failed cart
+      }
+    }
+  });
+
+  for (int p = 0; p < PRODUCTS; p++) {
+    string id = "S" + to_string(p);
+    CHECK(sold[p] <= STOCK, "sold more than the stock of " + id);
+    CHECK(engine.getReserved(id) == 0, "reservations left behind on " + id);
+    CHECK(sold[p] + engine.getAvailable(id) == STOCK,
+          "units lost or created on " + id);
+  }
+  cout << "carts       ok" << endl;
+}
+
+// ============================================
+// REGISTRY
+// ============================================
+
+static void testRegistry() {
+  const int EXISTING = 200;
+  const int ADDED = 3000;
+  InventoryEngine engine;
+  engine.load(catalog(EXISTING, 1));
+
+  vector<int> slots(EXISTING);
+  for (int i = 0; i < EXISTING; i++)
+    slots[i] = engine.slotOf("S" + to_string(i));
+
+  atomic<bool> writing{true};
+  vector<thread> readers;
+  for (int t = 0; t < THREADS - 1; t++) {
+    readers.emplace_back([&, t] {
+      mt19937 random(200 + t);
+      while (writing) {
+        int i = random() % EXISTING;
+        CHECK(engine.slotOf("S" + to_string(i)) == slots[i],
+              "a lookup lost or moved a slot during registration");
+      }
+    });
+  }
+  for (int i = 0; i < ADDED; i++)
+    engine.setOnHand("N" + to_string(i), i);
+  writing = false;
+  for (thread &reader : readers)
+    reader.join();
+
+  for (int i = 0; i < ADDED; i++) {
+    string id = "N" + to_string(i);
+    CHECK(engine.slotOf(id) >= EXISTING, "new product missing: " + id);
+    CHECK(engine.getAvailable(id) == i, "wrong stock for " + id);
+  }
+
+  // With no readers left, the next publish frees every old snapshot
+  engine.setOnHand("LAST", 1);
+  CHECK(engine.getRegistryVersionCount() == 1,
+        "replaced registry snapshots were not reclaimed");
+  cout << "registry    ok: " << ADDED << " products added under "
+       << THREADS - 1 << " readers" << endl;
+}
+
+int main() {
+  testOversell(false);
+  testOversell(true);
+  testCarts();
+  testRegistry();
+  cout << "All inventory stress checks passed." << endl;
+  return 0;
+}